@@ -0,0 +1,168 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <endian/big_endian.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+// Walk the headers of a buffer before handing it to the deserializer, as
+// done by applications parsing untrusted buffers without the validating
+// set_buffer().
+bool validate(const uint8_t* data, std::size_t size)
+{
+    if (size <= sizeof(uint16_t))
+    {
+        return false;
+    }
+
+    std::size_t offset = 0;
+    uint16_t remaining = 0;
+    while (size - offset > sizeof(uint16_t))
+    {
+        auto header = endian::big_endian::get<uint16_t>(data + offset);
+        offset += sizeof(uint16_t);
+
+        bool start = (header & 0x8000) != 0;
+        uint16_t length = header & 0x7FFF;
+        if (start && length == 0)
+        {
+            return false;
+        }
+
+        if (start || (length == remaining && length != 0))
+        {
+            auto bytes = std::min<std::size_t>(size - offset, length);
+            remaining = (uint16_t)(length - bytes);
+            offset += bytes;
+            continue;
+        }
+
+        offset += std::min<std::size_t>(size - offset, length);
+    }
+    return true;
+}
+
+// In this example a stream of buffers is parsed three times, without any
+// validation, with a validation pass before the deserializer and with the
+// validating set_buffer() of the deserializer. The buffer rate of each
+// approach is printed.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    uint32_t object_count = 200000;
+    uint16_t max_buffer_size = 1400;
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 500), (uint8_t)i);
+    }
+
+    // serialize all objects into concatenated buffers
+    chunkie::serializer<uint16_t> serializer;
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<uint8_t> buffer;
+
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data(), (uint16_t)object.size());
+        while (!serializer.object_proccessed())
+        {
+            if (max_buffer_size - buffer.size() <= sizeof(uint16_t))
+            {
+                buffers.push_back(buffer);
+                buffer.clear();
+            }
+
+            auto size = std::min<uint16_t>(
+                (uint16_t)(max_buffer_size - buffer.size()),
+                serializer.max_write_buffer_size());
+            auto offset = buffer.size();
+            buffer.resize(offset + size);
+            serializer.write_buffer(buffer.data() + offset, size);
+        }
+    }
+    buffers.push_back(buffer);
+
+    std::vector<uint8_t> object(0x8000);
+
+    for (uint32_t mode = 0; mode < 3; ++mode)
+    {
+        chunkie::deserializer<uint16_t> deserializer;
+        uint64_t received = 0;
+        uint64_t rejected = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t round = 0; round < 10; ++round)
+        {
+            for (const auto& buffer : buffers)
+            {
+                auto size = (uint16_t)buffer.size();
+                std::error_code error;
+
+                if (mode == 0)
+                {
+                    deserializer.set_buffer(buffer.data(), size);
+                }
+                else if (mode == 1)
+                {
+                    if (!validate(buffer.data(), size))
+                    {
+                        rejected++;
+                        continue;
+                    }
+                    deserializer.set_buffer(buffer.data(), size);
+                }
+                else
+                {
+                    deserializer.set_buffer(buffer.data(), size, error);
+                }
+
+                while (!error && !deserializer.buffer_proccessed())
+                {
+                    if (mode == 2)
+                    {
+                        deserializer.write_to_object(object.data(), error);
+                    }
+                    else
+                    {
+                        deserializer.write_to_object(object.data());
+                    }
+
+                    if (deserializer.object_completed())
+                    {
+                        received++;
+                    }
+                }
+
+                if (error)
+                {
+                    rejected++;
+                }
+            }
+        }
+
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        const char* names[] = {"unchecked", "validation pass",
+                               "validating set_buffer"};
+
+        std::cout << names[mode] << ": "
+                  << (10 * buffers.size() / seconds) / 1e6
+                  << " million buffers/s (" << received << " objects, "
+                  << rejected << " rejected)" << std::endl;
+    }
+
+    return 0;
+}
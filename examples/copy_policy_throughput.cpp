@@ -0,0 +1,168 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/prefetch_copy.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/standard_copy.hpp>
+#include <chunkie/streaming_copy.hpp>
+#include <chunkie/threshold_copy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Walk a random cycle through a working set which fits in the cache until
+// stopped, as a stand-in for a cache sensitive workload on the same machine.
+// @return the number of steps per second
+static double cache_sensitive_workload(const std::vector<uint32_t>& cycle,
+                                       const std::atomic<bool>& stop)
+{
+    uint64_t steps = 0;
+    uint32_t position = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            position = cycle[position];
+        }
+        steps += 1024;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Keep the walk from being optimized away
+    if (position == cycle.size())
+    {
+        std::cout << position;
+    }
+
+    return steps / std::chrono::duration<double>(end - start).count();
+}
+
+// Serialize and deserialize a huge object a number of times
+// @return the throughput in MB/s
+template <class CopyPolicy>
+static double serialize_deserialize(const std::vector<uint8_t>& object,
+                                    std::vector<uint8_t>& result,
+                                    uint32_t rounds)
+{
+    chunkie::serializer<uint32_t, chunkie::no_extension, CopyPolicy>
+        serializer;
+    chunkie::deserializer<uint32_t, chunkie::no_extension, CopyPolicy>
+        deserializer;
+
+    std::vector<uint8_t> buffer(64000);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; ++i)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+
+        while (!serializer.object_proccessed())
+        {
+            auto size = std::min<uint32_t>((uint32_t)buffer.size(),
+                                           serializer.max_write_buffer_size());
+            serializer.write_buffer(buffer.data(), size);
+
+            deserializer.set_buffer(buffer.data(), size);
+            deserializer.write_to_object(result.data());
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return (object.size() * (double)rounds / seconds) / 1e6;
+}
+
+// Run the copy alone, and with a co-running cache sensitive workload
+// @param alone_steps the steps per second of the workload running alone
+template <class CopyPolicy>
+static void run(const char* name, const std::vector<uint8_t>& object,
+                std::vector<uint8_t>& result,
+                const std::vector<uint32_t>& cycle, uint32_t rounds,
+                double alone_steps)
+{
+    double alone = serialize_deserialize<CopyPolicy>(object, result, rounds);
+
+    std::atomic<bool> stop{false};
+    double steps = 0;
+
+    std::thread workload(
+        [&]() { steps = cache_sensitive_workload(cycle, stop); });
+
+    double throughput =
+        serialize_deserialize<CopyPolicy>(object, result, rounds);
+    stop = true;
+    workload.join();
+
+    std::cout << name << ": " << alone << " MB/s alone, " << throughput
+              << " MB/s co-running, workload at "
+              << 100.0 * steps / alone_steps << "% of its speed alone"
+              << std::endl;
+}
+
+// In this example a 64 MB object is serialized and deserialized with each
+// copy policy, first alone and then while another thread walks a working set
+// which fits in the cache. The throughput of chunkie and the slowdown of the
+// co-running workload are printed. The comparison measures cache pressure
+// only when the two threads run on separate cores, so at least two cores
+// sharing a last level cache are needed.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (std::thread::hardware_concurrency() < 2)
+    {
+        std::cout << "Only one core is available, the threads take turns on "
+                     "it and the co-running results show time slicing "
+                     "rather than cache pressure"
+                  << std::endl;
+    }
+
+    uint32_t rounds = 10;
+    std::vector<uint8_t> object(64 * 1024 * 1024, 'x');
+    std::vector<uint8_t> result(object.size());
+
+    // A random cycle through 2 MB
+    std::vector<uint32_t> order(512 * 1024);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin() + 1, order.end(), std::mt19937(42));
+    std::vector<uint32_t> cycle(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        cycle[order[i]] = order[(i + 1) % order.size()];
+    }
+
+    double steps = 0;
+    {
+        std::atomic<bool> stop{false};
+        std::thread workload(
+            [&]() { steps = cache_sensitive_workload(cycle, stop); });
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        stop = true;
+        workload.join();
+        std::cout << "workload alone: " << steps / 1e6 << " million steps/s"
+                  << std::endl;
+    }
+
+    run<chunkie::standard_copy>("standard_copy", object, result, cycle,
+                                rounds, steps);
+    run<chunkie::streaming_copy>("streaming_copy", object, result, cycle,
+                                 rounds, steps);
+    run<chunkie::prefetch_copy>("prefetch_copy", object, result, cycle,
+                                rounds, steps);
+    run<chunkie::threshold_copy<>>("threshold_copy", object, result, cycle,
+                                   rounds, steps);
+
+    return 0;
+}
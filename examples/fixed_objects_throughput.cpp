@@ -0,0 +1,148 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/fixed_deserializer.hpp>
+#include <chunkie/fixed_serializer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// In this example a stream of objects of one constant size is packed into
+// buffers and reassembled, first with the serializer and deserializer, then
+// with the fixed_serializer and fixed_deserializer, and finally with buffers
+// aligned to the objects. The number of bytes sent and the object rate of
+// each approach is printed.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    const std::size_t object_size = 160;
+    const uint32_t object_count = 1000000;
+    const uint32_t max_buffer_size = 1400;
+
+    std::vector<uint8_t> input(object_size);
+    std::vector<uint8_t> output(object_size);
+    std::vector<uint8_t> buffer(max_buffer_size);
+
+    for (uint32_t mode = 0; mode < 3; ++mode)
+    {
+        uint64_t sent = 0;
+        uint64_t received = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (mode == 0)
+        {
+            chunkie::serializer<uint16_t> serializer;
+            chunkie::deserializer<uint16_t> deserializer;
+
+            uint32_t size = 0;
+            for (uint32_t i = 0; i < object_count; ++i)
+            {
+                input[0] = (uint8_t)i;
+                serializer.set_object(input.data(), object_size);
+                while (!serializer.object_proccessed())
+                {
+                    auto bytes = std::min<uint32_t>(
+                        max_buffer_size - size,
+                        serializer.max_write_buffer_size());
+                    serializer.write_buffer(buffer.data() + size,
+                                            (uint16_t)bytes);
+                    size += bytes;
+
+                    if (max_buffer_size - size <= sizeof(uint16_t) ||
+                        i + 1 == object_count)
+                    {
+                        deserializer.set_buffer(buffer.data(),
+                                                (uint16_t)size);
+                        while (!deserializer.buffer_proccessed())
+                        {
+                            deserializer.write_to_object(output.data());
+                            received += deserializer.object_completed();
+                        }
+                        sent += size;
+                        size = 0;
+                    }
+                }
+            }
+        }
+        else if (mode == 1)
+        {
+            chunkie::fixed_serializer<object_size> serializer;
+            chunkie::fixed_deserializer<object_size> deserializer;
+
+            serializer.set_buffer(buffer.data(), max_buffer_size);
+            for (uint32_t i = 0; i < object_count; ++i)
+            {
+                input[0] = (uint8_t)i;
+                serializer.set_object(input.data());
+                while (!serializer.object_proccessed())
+                {
+                    serializer.write();
+
+                    if (serializer.buffer_remaining() == 0 ||
+                        i + 1 == object_count)
+                    {
+                        auto size = serializer.buffer_size();
+                        deserializer.set_buffer(buffer.data(), size);
+                        while (!deserializer.buffer_proccessed())
+                        {
+                            deserializer.write_to_object(output.data());
+                            received += deserializer.object_completed();
+                        }
+                        sent += size;
+                        serializer.set_buffer(buffer.data(), max_buffer_size);
+                    }
+                }
+            }
+        }
+        else
+        {
+            chunkie::fixed_serializer<object_size, true> serializer;
+            chunkie::fixed_deserializer<object_size, true> deserializer;
+
+            // the largest multiple of the object size
+            auto buffer_size = max_buffer_size / object_size * object_size;
+
+            serializer.set_buffer(buffer.data(), buffer_size);
+            for (uint32_t i = 0; i < object_count; ++i)
+            {
+                input[0] = (uint8_t)i;
+                serializer.set_object(input.data());
+                serializer.write();
+
+                if (serializer.buffer_remaining() == 0 ||
+                    i + 1 == object_count)
+                {
+                    auto size = serializer.buffer_size();
+                    deserializer.set_buffer(buffer.data(), size);
+                    while (!deserializer.buffer_proccessed())
+                    {
+                        deserializer.write_to_object(output.data());
+                        received += deserializer.object_completed();
+                    }
+                    sent += size;
+                    serializer.set_buffer(buffer.data(), buffer_size);
+                }
+            }
+        }
+
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        const char* names[] = {"serializer", "fixed_serializer",
+                               "aligned fixed_serializer"};
+
+        std::cout << names[mode] << ": " << (received / seconds) / 1e6
+                  << " million objects/s, "
+                  << sent - (uint64_t)object_count * object_size
+                  << " bytes of headers" << std::endl;
+    }
+
+    return 0;
+}
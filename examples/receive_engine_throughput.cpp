@@ -0,0 +1,104 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/receive_engine.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// In this example buffers from many independent streams are deserialized by
+// the sharded receive engine using an increasing number of worker threads,
+// and the resulting throughput is printed for each thread count.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    uint32_t streams = 64;
+    uint32_t objects_per_stream = 200;
+    uint32_t max_buffer_size = 1400;
+
+    // serialize the objects of all streams up front
+    std::vector<std::vector<std::vector<uint8_t>>> buffers(streams);
+    uint64_t total_bytes = 0;
+
+    for (uint32_t stream = 0; stream < streams; ++stream)
+    {
+        chunkie::serializer<uint32_t> serializer;
+
+        for (uint32_t i = 0; i < objects_per_stream; ++i)
+        {
+            std::vector<uint8_t> object(100 + (rand() % 10000), rand());
+            serializer.set_object(object.data(), object.size());
+
+            while (!serializer.object_proccessed())
+            {
+                auto buffer_size = std::min<uint32_t>(
+                    max_buffer_size, serializer.max_write_buffer_size());
+
+                std::vector<uint8_t> buffer(buffer_size);
+                serializer.write_buffer(buffer.data(), buffer.size());
+
+                total_bytes += buffer.size();
+                buffers[stream].push_back(std::move(buffer));
+            }
+        }
+    }
+
+    uint32_t max_threads = std::max(2U, std::thread::hardware_concurrency());
+
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        std::atomic<uint64_t> objects_received{0};
+
+        // Copy the buffers before timing, they are moved into the engine
+        auto received_buffers = buffers;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            chunkie::receive_engine<uint32_t> engine(
+                threads, 1024,
+                [&objects_received](uint64_t, chunkie::shared_object)
+                { objects_received.fetch_add(1, std::memory_order_relaxed); });
+
+            // interleave the buffers of the streams as they would arrive
+            for (std::size_t i = 0;; ++i)
+            {
+                bool pushed = false;
+                for (uint32_t stream = 0; stream < streams; ++stream)
+                {
+                    if (i < buffers[stream].size())
+                    {
+                        engine.push(stream,
+                                    std::move(received_buffers[stream][i]));
+                        pushed = true;
+                    }
+                }
+
+                if (!pushed)
+                {
+                    break;
+                }
+            }
+
+            engine.stop();
+        }
+        auto stop = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+
+        std::cout << threads << " threads: " << objects_received
+                  << " objects, " << (total_bytes / seconds) / 1e6 << " MB/s"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/buffer_range.hpp>
+#include <chunkie/deserializer.hpp>
+#include <chunkie/object_range.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// In this example objects are serialized and deserialized through lazy
+// ranges. The buffers of each object are written one at a time into the same
+// storage and handed directly to the deserializer, so the buffers are never
+// collected in a container.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    chunkie::serializer<uint32_t> serializer;
+    chunkie::deserializer<uint32_t> deserializer;
+
+    uint32_t max_buffer_size = 1000;
+
+    // some objects to be sent
+    std::vector<std::vector<uint8_t>> objects;
+    for (auto size : {1337, 28, 2681, 540, 12, 24, 48, 36, 212, 1024, 257, 42})
+    {
+        objects.emplace_back(size, rand());
+    }
+
+    std::vector<uint8_t> buffer(max_buffer_size);
+    std::vector<uint8_t> object;
+    uint32_t objects_restored = 0;
+
+    for (const auto& input : objects)
+    {
+        serializer.set_object(input.data(), (uint32_t)input.size());
+
+        // the buffers are written as the deserializer asks for them
+        auto buffers = chunkie::make_buffer_range(serializer, buffer.data(),
+                                                  max_buffer_size);
+
+        for (auto output : chunkie::make_object_range(
+                 deserializer, buffers.begin(), buffers.end(), object))
+        {
+            bool equals = std::equal(input.begin(), input.end(),
+                                     output.m_data,
+                                     output.m_data + output.m_size);
+            std::cout << "Deserialized object of size " << output.m_size
+                      << " " << (equals ? "correctly" : "incorrectly")
+                      << std::endl;
+
+            objects_restored++;
+        }
+    }
+
+    std::cout << objects_restored << " Objects deserialized!" << std::endl;
+
+    return 0;
+}
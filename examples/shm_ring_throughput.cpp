@@ -0,0 +1,225 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/shm_ring.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+const uint32_t object_count = 500000;
+const uint32_t object_size = 1000;
+const uint32_t max_buffer_size = 1400;
+
+uint64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Collects the objects received by the consumer process
+struct statistics
+{
+    void start()
+    {
+        m_start = now();
+    }
+
+    // Every object starts with the time it was serialized
+    void add(const std::vector<uint8_t>& object)
+    {
+        uint64_t sent;
+        std::memcpy(&sent, object.data(), sizeof(sent));
+        m_latency += now() - sent;
+        m_objects++;
+    }
+
+    void print(const char* name) const
+    {
+        double seconds = (now() - m_start) / 1e9;
+        std::cout << name << ": " << (m_objects / seconds) / 1e6
+                  << " million objects/s, "
+                  << m_latency / (double)m_objects / 1e3
+                  << " us mean latency" << std::endl;
+    }
+
+    uint64_t m_start = 0;
+    uint64_t m_latency = 0;
+    uint64_t m_objects = 0;
+};
+
+// Serialize all objects, handing each buffer to write
+template <typename Write>
+void produce(Write write)
+{
+    chunkie::serializer<uint32_t> serializer;
+    std::vector<uint8_t> object(object_size, 'x');
+
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        uint64_t timestamp = now();
+        std::memcpy(object.data(), &timestamp, sizeof(timestamp));
+        serializer.set_object(object.data(), object_size);
+
+        while (!serializer.object_proccessed())
+        {
+            auto size = std::min<uint32_t>(max_buffer_size,
+                                           serializer.max_write_buffer_size());
+            write(serializer, size);
+        }
+    }
+}
+
+// Deserialize a buffer, adding the completed objects to the statistics
+void consume(chunkie::deserializer<uint32_t>& deserializer,
+             std::vector<uint8_t>& object, statistics& stats,
+             const uint8_t* buffer, std::size_t size)
+{
+    deserializer.set_buffer(buffer, (uint32_t)size);
+    while (!deserializer.buffer_proccessed())
+    {
+        object.resize(deserializer.object_size());
+        deserializer.write_to_object(object.data());
+        if (deserializer.object_completed())
+        {
+            stats.add(object);
+        }
+    }
+}
+}
+
+// In this example objects are streamed from one process to another, first
+// through a shm_ring where the buffers are serialized into and deserialized
+// from shared memory, and then through a Unix domain socket. The object rate
+// and the mean latency from serialization to deserialization are printed by
+// the receiving process.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    // Shared memory ring
+    {
+        std::string name = "/chunkie_example_" + std::to_string(::getpid());
+        std::error_code error;
+
+        chunkie::shm_ring writer;
+        writer.create(name, max_buffer_size, 256, error);
+        if (error)
+        {
+            std::cout << "create failed: " << error.message() << std::endl;
+            return 1;
+        }
+
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            chunkie::shm_ring reader;
+            reader.open(name, error);
+            if (error)
+            {
+                std::cout << "open failed: " << error.message() << std::endl;
+                ::_exit(1);
+            }
+
+            chunkie::deserializer<uint32_t> deserializer;
+            std::vector<uint8_t> object;
+            statistics stats;
+            stats.start();
+
+            while (reader.wait_readable())
+            {
+                std::size_t size = 0;
+                const uint8_t* buffer = reader.peek(size, error);
+                if (error)
+                {
+                    std::cout << "peek failed: " << error.message()
+                              << std::endl;
+                    ::_exit(1);
+                }
+                consume(deserializer, object, stats, buffer, size);
+                reader.release();
+            }
+
+            stats.print("shm_ring");
+            ::_exit(0);
+        }
+
+        produce(
+            [&writer](chunkie::serializer<uint32_t>& serializer, uint32_t size)
+            {
+                writer.wait_writable();
+                serializer.write_buffer(writer.prepare(), size);
+                writer.commit(size);
+            });
+        writer.shutdown();
+
+        ::waitpid(child, nullptr, 0);
+        chunkie::shm_ring::remove(name, error);
+    }
+
+    // Unix domain socket
+    {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != 0)
+        {
+            std::cout << "socketpair failed" << std::endl;
+            return 1;
+        }
+
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            ::close(sockets[0]);
+
+            chunkie::deserializer<uint32_t> deserializer;
+            std::vector<uint8_t> buffer(max_buffer_size);
+            std::vector<uint8_t> object;
+            statistics stats;
+            stats.start();
+
+            while (true)
+            {
+                auto size = ::recv(sockets[1], buffer.data(), buffer.size(), 0);
+                if (size <= 0)
+                {
+                    break;
+                }
+                consume(deserializer, object, stats, buffer.data(),
+                        (std::size_t)size);
+            }
+
+            stats.print("unix socket");
+            ::_exit(0);
+        }
+
+        ::close(sockets[1]);
+        std::vector<uint8_t> buffer(max_buffer_size);
+
+        produce(
+            [&](chunkie::serializer<uint32_t>& serializer, uint32_t size)
+            {
+                serializer.write_buffer(buffer.data(), size);
+                ::send(sockets[0], buffer.data(), size, 0);
+            });
+        ::close(sockets[0]);
+
+        ::waitpid(child, nullptr, 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/serializer.hpp>
+#include <chunkie/submission_serializer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// In this example an increasing number of producer threads write objects
+// to a single stream of buffers, first by sharing a serializer protected
+// by a mutex and then by submitting them to a submission_serializer drained
+// by a consumer thread. The average time a producer spends handing over an
+// object is printed for each thread count.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    const uint32_t objects_per_thread = 20000;
+    const uint32_t max_buffer_size = 1400;
+    uint32_t max_threads = std::max(4U, std::thread::hardware_concurrency());
+
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        for (uint32_t mode = 0; mode < 2; ++mode)
+        {
+            std::mutex mutex;
+            chunkie::serializer<uint32_t> shared_serializer;
+            std::vector<uint8_t> shared_buffer(max_buffer_size);
+
+            chunkie::submission_serializer<uint32_t> serializer;
+            std::atomic<bool> done{false};
+            std::atomic<uint64_t> handover_ns{0};
+
+            // drain the submissions into buffers
+            std::thread consumer(
+                [&]()
+                {
+                    std::vector<uint8_t> buffer(max_buffer_size);
+                    while (!done || serializer.has_objects())
+                    {
+                        if (serializer.write_buffer(buffer.data(),
+                                                    max_buffer_size) == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+
+            std::vector<std::thread> producers;
+            for (uint32_t t = 0; t < threads; ++t)
+            {
+                producers.emplace_back(
+                    [&]()
+                    {
+                        std::vector<uint8_t> object(200, 'x');
+                        chunkie::submission submission;
+                        uint64_t elapsed = 0;
+
+                        for (uint32_t i = 0; i < objects_per_thread; ++i)
+                        {
+                            auto start = std::chrono::steady_clock::now();
+
+                            if (mode == 0)
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                shared_serializer.set_object(
+                                    object.data(), (uint32_t)object.size());
+                                while (!shared_serializer.object_proccessed())
+                                {
+                                    auto size = std::min<uint32_t>(
+                                        max_buffer_size,
+                                        shared_serializer
+                                            .max_write_buffer_size());
+                                    shared_serializer.write_buffer(
+                                        shared_buffer.data(), size);
+                                }
+                            }
+                            else
+                            {
+                                submission.m_data = object.data();
+                                submission.m_size = object.size();
+                                serializer.submit(submission);
+                            }
+
+                            auto stop = std::chrono::steady_clock::now();
+                            elapsed += std::chrono::duration_cast<
+                                           std::chrono::nanoseconds>(stop -
+                                                                     start)
+                                           .count();
+
+                            // wait before the object memory is reused
+                            while (!submission.completed())
+                            {
+                                std::this_thread::yield();
+                            }
+                        }
+
+                        handover_ns += elapsed;
+                    });
+            }
+
+            for (auto& producer : producers)
+            {
+                producer.join();
+            }
+            done = true;
+            consumer.join();
+
+            const char* names[] = {"mutex", "submission_serializer"};
+            std::cout << threads << " threads, " << names[mode] << ": "
+                      << handover_ns / (double)(threads * objects_per_thread)
+                      << " ns per object handed over" << std::endl;
+        }
+    }
+
+    return 0;
+}
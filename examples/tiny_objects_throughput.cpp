@@ -0,0 +1,118 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/tiny_deserializer.hpp>
+#include <chunkie/tiny_serializer.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// In this example a flood of tiny objects is packed into buffers and split
+// again, first with the serializer and deserializer one object at a time and
+// then with the batched tiny_serializer and tiny_deserializer. The object
+// rate of both approaches is printed.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    uint32_t object_count = 1000000;
+    // with uint8_t headers the deserializer accepts buffers up to 255 bytes
+    uint32_t max_buffer_size = 255;
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<chunkie::object_view<uint8_t>> views;
+
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 63), (uint8_t)i);
+    }
+    for (const auto& object : objects)
+    {
+        views.push_back({object.data(), (uint8_t)object.size()});
+    }
+
+    std::vector<uint8_t> buffer(max_buffer_size);
+    std::vector<uint8_t> object(127);
+
+    for (uint32_t mode = 0; mode < 2; ++mode)
+    {
+        uint64_t received = 0;
+        uint64_t checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (mode == 0)
+        {
+            chunkie::serializer<uint8_t> serializer;
+            chunkie::deserializer<uint8_t> deserializer;
+
+            std::size_t index = 0;
+            while (index < objects.size())
+            {
+                // pack whole objects into the buffer
+                std::size_t size = 0;
+                while (index < objects.size() &&
+                       size + 1 + objects[index].size() <= max_buffer_size)
+                {
+                    serializer.set_object(objects[index].data(),
+                                          (uint8_t)objects[index].size());
+                    auto bytes = serializer.max_write_buffer_size();
+                    serializer.write_buffer(buffer.data() + size, bytes);
+                    size += bytes;
+                    index++;
+                }
+
+                deserializer.set_buffer(buffer.data(), (uint8_t)size);
+                while (!deserializer.buffer_proccessed())
+                {
+                    deserializer.write_to_object(object.data());
+                    checksum += object[0];
+                    received++;
+                }
+            }
+        }
+        else
+        {
+            chunkie::tiny_serializer<uint8_t> serializer;
+            chunkie::tiny_deserializer<uint8_t> deserializer;
+            std::vector<chunkie::object_view<uint8_t>> received_views(
+                max_buffer_size / 2);
+
+            std::size_t index = 0;
+            while (index < views.size())
+            {
+                std::size_t size = 0;
+                index += serializer.write_objects(
+                    views.data() + index, views.size() - index, buffer.data(),
+                    buffer.size(), size);
+
+                std::size_t consumed = 0;
+                auto count = deserializer.read_objects(
+                    buffer.data(), size, received_views.data(),
+                    received_views.size(), consumed);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    checksum += received_views[i].m_data[0];
+                }
+                received += count;
+            }
+        }
+
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        const char* names[] = {"serializer", "tiny_serializer"};
+
+        std::cout << names[mode] << ": " << (received / seconds) / 1e6
+                  << " million objects/s (checksum " << checksum << ")"
+                  << std::endl;
+    }
+
+    return 0;
+}
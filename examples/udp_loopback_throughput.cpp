@@ -0,0 +1,157 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/udp_receiver.hpp>
+#include <chunkie/udp_sender.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+// In this example objects are serialized and sent over the loopback
+// interface, first with one send system call per buffer, then batched with
+// sendmmsg and finally batched with generic segmentation offload. The
+// throughput and the number of system calls of each approach is printed.
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    uint32_t max_buffer_size = 1400;
+    uint32_t batch_size = 64;
+    uint32_t objects = 2000;
+
+    std::vector<uint8_t> object(20000, 'x');
+
+    for (uint32_t mode = 0; mode < 3; ++mode)
+    {
+        int receiver_socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+        int sender_socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+        int socket_buffer = 8 * 1024 * 1024;
+        ::setsockopt(receiver_socket, SOL_SOCKET, SO_RCVBUF, &socket_buffer,
+                     sizeof(socket_buffer));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(receiver_socket, (sockaddr*)&address, sizeof(address));
+        socklen_t length = sizeof(address);
+        ::getsockname(receiver_socket, (sockaddr*)&address, &length);
+        ::connect(sender_socket, (sockaddr*)&address, sizeof(address));
+
+        std::atomic<bool> done{false};
+        std::atomic<uint32_t> objects_received{0};
+
+        // receive and deserialize until the sender is done
+        std::thread receiving(
+            [&]()
+            {
+                timeval timeout{0, 100000};
+                ::setsockopt(receiver_socket, SOL_SOCKET, SO_RCVTIMEO,
+                             &timeout, sizeof(timeout));
+
+                chunkie::udp_receiver receiver(
+                    receiver_socket, max_buffer_size, batch_size, true);
+                chunkie::deserializer<uint32_t> deserializer;
+                std::vector<uint8_t> output;
+
+                while (!done)
+                {
+                    std::error_code error;
+                    receiver.receive(error);
+
+                    for (std::size_t i = 0; i < receiver.buffers(); ++i)
+                    {
+                        deserializer.set_buffer(
+                            receiver.buffer_data(i),
+                            (uint32_t)receiver.buffer_size(i));
+
+                        while (!deserializer.buffer_proccessed())
+                        {
+                            output.resize(deserializer.object_size());
+                            deserializer.write_to_object(output.data());
+                            if (deserializer.object_completed())
+                            {
+                                objects_received++;
+                            }
+                        }
+                    }
+                }
+            });
+
+        chunkie::serializer<uint32_t> serializer;
+        chunkie::udp_sender sender(sender_socket, max_buffer_size, batch_size);
+        sender.set_gso(mode == 2);
+
+        std::vector<uint8_t> buffer(max_buffer_size);
+        uint64_t system_calls = 0;
+        uint64_t buffers = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < objects; ++i)
+        {
+            serializer.set_object(object.data(), object.size());
+
+            while (!serializer.object_proccessed())
+            {
+                auto size = std::min<uint32_t>(
+                    max_buffer_size, serializer.max_write_buffer_size());
+
+                if (mode == 0)
+                {
+                    serializer.write_buffer(buffer.data(), size);
+                    ::send(sender_socket, buffer.data(), size, 0);
+                    system_calls++;
+                }
+                else
+                {
+                    std::error_code error;
+                    serializer.write_buffer(sender.prepare(error), size);
+                    sender.commit(size);
+                }
+                buffers++;
+            }
+        }
+
+        std::error_code error;
+        sender.flush(error);
+
+        auto stop = std::chrono::steady_clock::now();
+
+        if (mode != 0)
+        {
+            system_calls = sender.system_calls();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        done = true;
+        receiving.join();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        const char* names[] = {"send", "sendmmsg", "sendmmsg + GSO"};
+
+        std::cout << names[mode] << ": " << buffers / seconds
+                  << " buffers/s, " << system_calls << " system calls for "
+                  << buffers << " buffers, " << objects_received << " of "
+                  << objects << " objects received" << std::endl;
+
+        ::close(receiver_socket);
+        ::close(sender_socket);
+    }
+
+    return 0;
+}
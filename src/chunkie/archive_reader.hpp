@@ -0,0 +1,427 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <endian/big_endian.hpp>
+
+#include <bitter/msb0_reader.hpp>
+
+#include "archive_writer.hpp"
+#include "chunk_file_reader.hpp"
+#include "deserializer.hpp"
+#include "error.hpp"
+
+namespace chunkie
+{
+/// Reads individual objects from an archive written by an archive_writer.
+///
+/// The index of the archive is loaded when it is opened, by following the
+/// index blocks back from the trailer. If the trailer is missing, because
+/// the recording was interrupted, the index is recovered from the index
+/// blocks and the records following the last of them. Reading an object
+/// seeks to the record in which it starts and reads only the records
+/// holding it, so the cost of reading an object does not depend on its
+/// position in the archive.
+///
+/// The records are validated while an object is read, so a corrupt or
+/// truncated archive is reported as error::invalid_archive and never writes
+/// beyond the size of the object given by the index.
+///
+/// The Extension must match the start header extension of the serializer.
+///
+/// Available on POSIX platforms.
+template <typename HeaderType = uint32_t, typename Extension = no_extension>
+class archive_reader
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The start header extension
+    using extension_type = Extension;
+
+private:
+    /// The header consists of a size and a start bit
+    using header_reader =
+        bitter::msb0_reader<header_type, 1, (sizeof(header_type) * 8) - 1>;
+
+public:
+    /// Open an archive and load its index
+    /// @param path the path of the archive
+    /// @param batch_size the size of each read batch in bytes, must be at
+    ///        least the size of the largest record, index blocks included
+    void open(const std::string& path, std::size_t batch_size,
+              std::error_code& error)
+    {
+        assert(!is_open() && "Archive already open");
+
+        m_reader.open(path, batch_size, error);
+        if (error)
+        {
+            return;
+        }
+
+        load_index(path, error);
+        if (error)
+        {
+            close();
+        }
+    }
+
+    /// @return true if an archive is open
+    bool is_open() const
+    {
+        return m_reader.is_open();
+    }
+
+    /// @return the number of objects in the archive
+    std::size_t objects() const
+    {
+        return m_index.size() / writer_type::entry_size;
+    }
+
+    /// @return the size of an object
+    uint64_t object_size(std::size_t index) const
+    {
+        assert(index < objects() && "Object out of range");
+        return endian::big_endian::get<uint64_t>(entry(index) + 12);
+    }
+
+    /// Read an object
+    /// @param index the number of the object
+    /// @param object the memory to write the object to, must hold
+    ///        object_size(index) bytes
+    /// @return true if the object was read
+    bool read_object(std::size_t index, uint8_t* object,
+                     std::error_code& error)
+    {
+        assert(is_open() && "Archive not open");
+        assert(index < objects() && "Object out of range");
+        assert(object != nullptr && "Null pointer provided");
+
+        auto record_offset = endian::big_endian::get<uint64_t>(entry(index));
+        auto position = endian::big_endian::get<uint32_t>(entry(index) + 8);
+        auto remaining = object_size(index);
+
+        m_reader.seek(record_offset);
+
+        // A new deserializer, as the previous read may have stopped inside a
+        // buffer
+        deserializer<header_type, extension_type> reader;
+
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+        bool first = true;
+
+        // The file offset of the next record
+        uint64_t offset = record_offset;
+
+        while (offset < m_records_end &&
+               m_reader.read_buffer(data, size, error))
+        {
+            auto record = offset;
+            offset += chunk_file_reader::record_header_size + size;
+
+            if (std::binary_search(m_blocks.begin(), m_blocks.end(), record))
+            {
+                continue;
+            }
+
+            if (first)
+            {
+                if (offset > m_records_end ||
+                    position + sizeof(header_type) >= size)
+                {
+                    error = chunkie::error::invalid_archive;
+                    return false;
+                }
+
+                data += position;
+                size -= position;
+            }
+            else if (size <= sizeof(header_type))
+            {
+                continue;
+            }
+
+            // The record must start or continue the object, as another
+            // object could be larger than the memory given
+            auto header = header_reader(
+                endian::big_endian::get<header_type>(data));
+            auto start = header.template field<0>().template as<bool>();
+            auto bytes = header.template field<1>().template as<header_type>();
+
+            if (offset > m_records_end || start != first ||
+                bytes != remaining ||
+                size > std::numeric_limits<header_type>::max())
+            {
+                error = chunkie::error::invalid_archive;
+                return false;
+            }
+
+            reader.set_buffer(data, (header_type)size, error);
+            while (!error && !reader.buffer_proccessed())
+            {
+                reader.write_to_object(object, error);
+                if (!error && reader.object_completed())
+                {
+                    return true;
+                }
+            }
+
+            if (error)
+            {
+                error = chunkie::error::invalid_archive;
+                return false;
+            }
+
+            // The rest of the record belongs to the object
+            remaining -= size - sizeof(header_type) -
+                         (first ? extension_type::size : 0);
+            first = false;
+        }
+
+        if (!error)
+        {
+            // The archive ended before the object
+            error = chunkie::error::invalid_archive;
+        }
+        return false;
+    }
+
+    /// Close the archive
+    void close()
+    {
+        assert(is_open() && "Archive not open");
+        m_reader.close();
+        m_index.clear();
+        m_blocks.clear();
+        m_records_end = 0;
+    }
+
+private:
+    using writer_type = archive_writer<header_type, extension_type>;
+
+    /// @return the index entry of an object
+    const uint8_t* entry(std::size_t index) const
+    {
+        return m_index.data() + index * writer_type::entry_size;
+    }
+
+    /// Read the trailer and the index blocks of an archive, or recover the
+    /// index if the trailer is missing
+    void load_index(const std::string& path, std::error_code& error)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return;
+        }
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            ::close(fd);
+            return;
+        }
+
+        uint64_t file_size = (uint64_t)status.st_size;
+        uint8_t trailer[chunk_file_reader::record_header_size +
+                        writer_type::trailer_size];
+
+        bool has_trailer = file_size >= sizeof(trailer) &&
+                           read_all(fd, trailer, sizeof(trailer),
+                                    file_size - sizeof(trailer), error);
+        ::close(fd);
+
+        if (error)
+        {
+            return;
+        }
+
+        const uint8_t* fields = trailer + chunk_file_reader::record_header_size;
+        has_trailer = has_trailer &&
+                      endian::big_endian::get<uint32_t>(trailer) ==
+                          writer_type::trailer_size &&
+                      endian::big_endian::get<uint64_t>(fields + 16) ==
+                          writer_type::magic;
+
+        if (!has_trailer)
+        {
+            recover_index(error);
+            return;
+        }
+
+        m_records_end = file_size - sizeof(trailer);
+        auto block = endian::big_endian::get<uint64_t>(fields);
+        auto count = endian::big_endian::get<uint64_t>(fields + 8);
+
+        // The blocks are found from the last to the first
+        std::vector<std::vector<uint8_t>> blocks;
+        uint64_t total = 0;
+
+        while (block != writer_type::no_block)
+        {
+            const uint8_t* data = nullptr;
+            std::size_t size = 0;
+
+            if (block >= m_records_end ||
+                (!m_blocks.empty() && block >= m_blocks.back()))
+            {
+                error = chunkie::error::invalid_archive;
+                return;
+            }
+
+            m_reader.seek(block);
+            if (!m_reader.read_buffer(data, size, error) ||
+                !is_block(data, size))
+            {
+                if (!error)
+                {
+                    error = chunkie::error::invalid_archive;
+                }
+                return;
+            }
+
+            m_blocks.push_back(block);
+            blocks.emplace_back(data + writer_type::block_header_size,
+                                data + size);
+            total += blocks.back().size() / writer_type::entry_size;
+            block = endian::big_endian::get<uint64_t>(data + 8);
+        }
+
+        if (total != count)
+        {
+            error = chunkie::error::invalid_archive;
+            return;
+        }
+
+        std::reverse(m_blocks.begin(), m_blocks.end());
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it)
+        {
+            m_index.insert(m_index.end(), it->begin(), it->end());
+        }
+    }
+
+    /// Rebuild the index of an archive without a trailer from its index
+    /// blocks, and the records following the last block
+    void recover_index(std::error_code& error)
+    {
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+        uint64_t offset = 0;
+        uint64_t last_block = writer_type::no_block;
+
+        // The entries of the records following the last block
+        std::vector<uint8_t> entries;
+
+        m_reader.seek(0);
+        while (m_reader.read_buffer(data, size, error))
+        {
+            auto record = offset;
+            offset += chunk_file_reader::record_header_size + size;
+
+            if (is_block(data, size) &&
+                endian::big_endian::get<uint64_t>(data + 8) == last_block)
+            {
+                m_blocks.push_back(record);
+                m_index.insert(m_index.end(),
+                               data + writer_type::block_header_size,
+                               data + size);
+                last_block = record;
+                entries.clear();
+                continue;
+            }
+
+            writer_type::index_record(data, size, record, entries);
+        }
+
+        // A record cut short by the interruption ends the archive
+        if (error == chunkie::error::truncated_record)
+        {
+            error = std::error_code();
+        }
+
+        m_index.insert(m_index.end(), entries.begin(), entries.end());
+        m_records_end = offset;
+    }
+
+    /// @return true if the record is an index block
+    static bool is_block(const uint8_t* data, std::size_t size)
+    {
+        if (size < writer_type::block_header_size + writer_type::entry_size ||
+            endian::big_endian::get<uint64_t>(data) !=
+                writer_type::block_magic)
+        {
+            return false;
+        }
+
+        auto count = endian::big_endian::get<uint32_t>(data + 16);
+        return size == writer_type::block_header_size +
+                           count * writer_type::entry_size;
+    }
+
+    /// Read exactly size bytes at the offset
+    /// @return true if all bytes were read
+    static bool read_all(int fd, uint8_t* data, std::size_t size,
+                         uint64_t offset, std::error_code& error)
+    {
+        std::size_t done = 0;
+        while (done < size)
+        {
+            auto result =
+                ::pread(fd, data + done, size - done, (off_t)(offset + done));
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                error = std::error_code(errno, std::generic_category());
+                return false;
+            }
+
+            if (result == 0)
+            {
+                return false;
+            }
+
+            done += (std::size_t)result;
+        }
+
+        return true;
+    }
+
+private:
+    /// The reader of the records
+    chunk_file_reader m_reader;
+
+    /// The index entries as stored in the archive
+    std::vector<uint8_t> m_index;
+
+    /// The file offsets of the index blocks, in increasing order
+    std::vector<uint64_t> m_blocks;
+
+    /// The file offset where the records end
+    uint64_t m_records_end = 0;
+};
+} // namespace chunkie
@@ -0,0 +1,318 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <endian/big_endian.hpp>
+
+#include <bitter/msb0_reader.hpp>
+
+#include "chunk_file_writer.hpp"
+#include "no_extension.hpp"
+
+namespace chunkie
+{
+/// Records serialized buffers to a seekable archive.
+///
+/// The records are written by a chunk_file_writer. While recording, every
+/// buffer is scanned for start headers and the location of each object is
+/// added to the index. The index is written incrementally, as index block
+/// records between the buffer records, each pointing back to the previous
+/// block. A trailer record pointing to the last block is written when the
+/// archive is closed:
+///
+///     | records | index block | records | index block | ... | trailer |
+///
+///     index block: | "CHUNKBLK" | previous block | entry count | entries |
+///     trailer:     | last block | object count | "CHUNKIDX" |
+///
+/// Each index entry holds the file offset of the record in which an object
+/// starts, the position of its start header in that record and the size of
+/// the object, all big endian. The archive_reader uses the index to read any
+/// object directly. If the recording was interrupted before the trailer was
+/// written, the archive_reader recovers the index from the index blocks.
+///
+/// The Extension must match the start header extension of the serializer.
+///
+/// Available on POSIX platforms.
+template <typename HeaderType = uint32_t, typename Extension = no_extension>
+class archive_writer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The start header extension
+    using extension_type = Extension;
+
+    /// Identifies the trailer of an archive, "CHUNKIDX"
+    static const uint64_t magic = 0x4348554E4B494458ULL;
+
+    /// Identifies an index block, "CHUNKBLK"
+    static const uint64_t block_magic = 0x4348554E4B424C4BULL;
+
+    /// The size of an index entry
+    static const std::size_t entry_size = 20;
+
+    /// The size of an index block before its entries
+    static const std::size_t block_header_size = 20;
+
+    /// The largest number of entries in an index block
+    static const std::size_t block_entries = 256;
+
+    /// The previous block offset of the first index block
+    static const uint64_t no_block = 0xFFFFFFFFFFFFFFFFULL;
+
+    /// The size of the trailer record
+    static const std::size_t trailer_size = 24;
+
+private:
+    /// The header consists of a size and a start bit
+    using header_reader =
+        bitter::msb0_reader<header_type, 1, (sizeof(header_type) * 8) - 1>;
+
+public:
+    /// Create or truncate the archive and prepare for writing
+    /// @param path the path of the archive
+    /// @param batch_size the size of each write batch in bytes, a record
+    ///        must fit in a single batch
+    void open(const std::string& path, std::size_t batch_size,
+              std::error_code& error)
+    {
+        assert(batch_size > chunk_file_writer::record_header_size +
+                                block_header_size + entry_size &&
+               "Batch too small for an index block");
+
+        m_writer.open(path, batch_size, error);
+        if (error)
+        {
+            return;
+        }
+
+        auto room = batch_size - chunk_file_writer::record_header_size -
+                    block_header_size;
+        m_block_entries = std::min(block_entries, room / entry_size);
+        m_entries.clear();
+        m_objects = 0;
+        m_last_block = no_block;
+    }
+
+    /// @return true if an archive is open
+    bool is_open() const
+    {
+        return m_writer.is_open();
+    }
+
+    /// Reserve space for a buffer of up to size bytes
+    /// @return pointer to write the buffer to, or nullptr on error
+    uint8_t* prepare(std::size_t size, std::error_code& error)
+    {
+        if (m_entries.size() >= m_block_entries * entry_size)
+        {
+            write_blocks(error);
+            if (error)
+            {
+                return nullptr;
+            }
+        }
+
+        m_prepared = m_writer.prepare(size, error);
+        return m_prepared;
+    }
+
+    /// Complete the buffer reserved by the last prepare() and index the
+    /// objects starting in it
+    /// @param size the size of the buffer
+    void commit(std::size_t size)
+    {
+        assert(m_prepared != nullptr && "No buffer prepared");
+
+        auto entries = m_entries.size();
+        index_record(m_prepared, size, m_writer.offset(), m_entries);
+        m_objects += (m_entries.size() - entries) / entry_size;
+
+        m_writer.commit(size);
+        m_prepared = nullptr;
+    }
+
+    /// Copy a buffer into the archive
+    void write(const uint8_t* data, std::size_t size, std::error_code& error)
+    {
+        assert(data != nullptr && "Null pointer provided");
+
+        uint8_t* record = prepare(size, error);
+        if (record == nullptr)
+        {
+            return;
+        }
+
+        std::copy(data, data + size, record);
+        commit(size);
+    }
+
+    /// @return the number of objects indexed so far
+    std::size_t objects() const
+    {
+        return (std::size_t)m_objects;
+    }
+
+    /// Write the remaining index entries and the trailer, and close the
+    /// archive
+    void close(std::error_code& error)
+    {
+        assert(is_open() && "Archive not open");
+
+        write_blocks(error);
+
+        uint8_t* trailer =
+            error ? nullptr : m_writer.prepare(trailer_size, error);
+        if (trailer != nullptr)
+        {
+            endian::big_endian::put<uint64_t>(m_last_block, trailer);
+            endian::big_endian::put<uint64_t>(m_objects, trailer + 8);
+            endian::big_endian::put<uint64_t>(magic, trailer + 16);
+            m_writer.commit(trailer_size);
+        }
+
+        std::error_code close_error;
+        m_writer.close(close_error);
+        if (!error)
+        {
+            error = close_error;
+        }
+    }
+
+    /// Append the index entries of the objects starting in a record, also
+    /// used by the archive_reader to recover an index
+    /// @param data the record
+    /// @param size the size of the record
+    /// @param record_offset the file offset of the record
+    /// @param entries the entries to append to
+    static void index_record(const uint8_t* data, std::size_t size,
+                             uint64_t record_offset,
+                             std::vector<uint8_t>& entries)
+    {
+        const std::size_t header_size = sizeof(header_type);
+        std::size_t position = 0;
+
+        while (size - position > header_size)
+        {
+            auto header = header_reader(
+                endian::big_endian::get<header_type>(data + position));
+            auto start = header.template field<0>().template as<bool>();
+            auto remaining =
+                header.template field<1>().template as<header_type>();
+
+            // Zero padding
+            if (remaining == 0)
+            {
+                break;
+            }
+
+            if (start)
+            {
+                auto entry = entries.size();
+                entries.resize(entry + entry_size);
+                endian::big_endian::put<uint64_t>(record_offset,
+                                                  &entries[entry]);
+                endian::big_endian::put<uint32_t>((uint32_t)position,
+                                                  &entries[entry] + 8);
+                endian::big_endian::put<uint64_t>(remaining,
+                                                  &entries[entry] + 12);
+            }
+
+            position += header_size;
+            if (start)
+            {
+                position += std::min<std::size_t>(size - position,
+                                                  extension_type::size);
+            }
+            position += std::min<std::size_t>(size - position, remaining);
+        }
+    }
+
+private:
+    /// Write the pending index entries as index blocks, so that the blocks
+    /// cover all records before them
+    void write_blocks(std::error_code& error)
+    {
+        std::size_t written = 0;
+        std::size_t pending = m_entries.size() / entry_size;
+
+        while (written < pending)
+        {
+            auto count = std::min(pending - written, m_block_entries);
+            auto size = block_header_size + count * entry_size;
+
+            uint8_t* block = m_writer.prepare(size, error);
+            if (block == nullptr)
+            {
+                break;
+            }
+
+            endian::big_endian::put<uint64_t>(block_magic, block);
+            endian::big_endian::put<uint64_t>(m_last_block, block + 8);
+            endian::big_endian::put<uint32_t>((uint32_t)count, block + 16);
+            std::copy(m_entries.begin() + written * entry_size,
+                      m_entries.begin() + (written + count) * entry_size,
+                      block + block_header_size);
+
+            m_last_block = m_writer.offset();
+            m_writer.commit(size);
+            written += count;
+        }
+
+        m_entries.erase(m_entries.begin(),
+                        m_entries.begin() + written * entry_size);
+    }
+
+private:
+    /// The writer of the records
+    chunk_file_writer m_writer;
+
+    /// The buffer reserved by the last prepare()
+    uint8_t* m_prepared = nullptr;
+
+    /// The index entries not yet written, as stored in the archive
+    std::vector<uint8_t> m_entries;
+
+    /// The number of entries in an index block, limited by the batch size
+    std::size_t m_block_entries = 0;
+
+    /// The number of objects indexed
+    uint64_t m_objects = 0;
+
+    /// The file offset of the last index block written
+    uint64_t m_last_block = no_block;
+};
+
+template <class T, class E>
+const uint64_t archive_writer<T, E>::magic;
+
+template <class T, class E>
+const uint64_t archive_writer<T, E>::block_magic;
+
+template <class T, class E>
+const std::size_t archive_writer<T, E>::entry_size;
+
+template <class T, class E>
+const std::size_t archive_writer<T, E>::block_header_size;
+
+template <class T, class E>
+const std::size_t archive_writer<T, E>::block_entries;
+
+template <class T, class E>
+const uint64_t archive_writer<T, E>::no_block;
+
+template <class T, class E>
+const std::size_t archive_writer<T, E>::trailer_size;
+} // namespace chunkie
@@ -0,0 +1,215 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace chunkie
+{
+/// The constants of the buffer_pool. They live in a class template so their
+/// definitions can be in the header without violating the one definition
+/// rule.
+template <class Dummy = void>
+class buffer_pool_constants
+{
+public:
+    /// The alignment of every buffer
+    static const std::size_t alignment = 64;
+
+protected:
+    /// Marks the end of the list of released buffers
+    static const uint32_t none = std::numeric_limits<uint32_t>::max();
+};
+
+template <class Dummy>
+const std::size_t buffer_pool_constants<Dummy>::alignment;
+
+template <class Dummy>
+const uint32_t buffer_pool_constants<Dummy>::none;
+
+/// Pool of fixed-size buffers for the serializer to write into.
+///
+/// All buffers are carved out of a single allocation at construction and
+/// each buffer starts on a cache line boundary. Buffers are acquired by a
+/// single thread, typically the one driving the serializer, and can be
+/// released from any thread without locking, e.g. by the transport once a
+/// buffer has been sent. Acquiring and releasing never allocates.
+///
+/// The serializer writes directly into the pool with
+/// serializer::write_pooled_buffer().
+class buffer_pool : public buffer_pool_constants<>
+{
+public:
+    /// @param buffer_size the size of each buffer in bytes
+    /// @param buffer_count the number of buffers in the pool
+    /// @param huge_pages if true, try to back the buffers with huge pages,
+    ///        falls back to regular pages if that is not possible
+    buffer_pool(std::size_t buffer_size, std::size_t buffer_count,
+                bool huge_pages = false) :
+        m_buffer_size(buffer_size),
+        m_stride((buffer_size + alignment - 1) / alignment * alignment),
+        m_buffer_count(buffer_count), m_next(buffer_count)
+    {
+        assert(buffer_size > 0 && "Buffers must have a size");
+        assert(buffer_count > 0 && "Pool must have buffers");
+        assert(buffer_count < none && "Too many buffers");
+
+        allocate(huge_pages);
+
+        m_free.reserve(buffer_count);
+        for (std::size_t i = buffer_count; i > 0; --i)
+        {
+            m_free.push_back((uint32_t)(i - 1));
+        }
+    }
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool()
+    {
+#if defined(__linux__)
+        if (m_mapped_size > 0)
+        {
+            munmap(m_data, m_mapped_size);
+        }
+#endif
+    }
+
+    /// Acquire a buffer. Must only be called from a single thread.
+    /// @return pointer to a buffer of buffer_size() bytes, or nullptr if
+    ///         all buffers are in use
+    uint8_t* acquire()
+    {
+        if (m_free.empty())
+        {
+            // Take over everything released since the last time at once
+            auto index = m_released.exchange(none, std::memory_order_acquire);
+            while (index != none)
+            {
+                m_free.push_back(index);
+                index = m_next[index];
+            }
+
+            if (m_free.empty())
+            {
+                return nullptr;
+            }
+        }
+
+        auto index = m_free.back();
+        m_free.pop_back();
+        return m_data + index * m_stride;
+    }
+
+    /// Return a buffer to the pool. May be called from any thread.
+    void release(uint8_t* buffer)
+    {
+        assert(buffer >= m_data && "Buffer not from this pool");
+        assert((std::size_t)(buffer - m_data) % m_stride == 0 &&
+               "Buffer not from this pool");
+
+        auto index = (uint32_t)((buffer - m_data) / m_stride);
+        assert(index < m_buffer_count && "Buffer not from this pool");
+
+        auto head = m_released.load(std::memory_order_relaxed);
+        do
+        {
+            m_next[index] = head;
+        } while (!m_released.compare_exchange_weak(
+            head, index, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// @return the size of each buffer in bytes
+    std::size_t buffer_size() const
+    {
+        return m_buffer_size;
+    }
+
+    /// @return the number of buffers in the pool
+    std::size_t buffer_count() const
+    {
+        return m_buffer_count;
+    }
+
+    /// @return true if the buffers are backed by huge pages
+    bool huge_pages() const
+    {
+        return m_mapped_size > 0;
+    }
+
+private:
+    /// Allocate the memory backing all buffers
+    void allocate(bool huge_pages)
+    {
+        std::size_t size = m_stride * m_buffer_count;
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+        if (huge_pages)
+        {
+            const std::size_t huge_page_size = 2 * 1024 * 1024;
+            std::size_t mapped_size =
+                (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+            void* data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<uint8_t*>(data);
+                m_mapped_size = mapped_size;
+                return;
+            }
+        }
+#else
+        (void)huge_pages;
+#endif
+
+        m_storage.reset(new uint8_t[size + alignment - 1]);
+
+        auto address = reinterpret_cast<std::uintptr_t>(m_storage.get());
+        auto offset = (alignment - (address % alignment)) % alignment;
+        m_data = m_storage.get() + offset;
+    }
+
+private:
+    /// The size of each buffer
+    std::size_t m_buffer_size;
+
+    /// The distance between the start of two buffers
+    std::size_t m_stride;
+
+    /// The number of buffers
+    std::size_t m_buffer_count;
+
+    /// Memory allocated on the heap when not using huge pages
+    std::unique_ptr<uint8_t[]> m_storage;
+
+    /// Size of the huge page mapping, zero if not mapped
+    std::size_t m_mapped_size = 0;
+
+    /// The aligned start of the first buffer
+    uint8_t* m_data = nullptr;
+
+    /// Indices of free buffers, only accessed by the acquiring thread
+    std::vector<uint32_t> m_free;
+
+    /// Next index in the list of released buffers
+    std::vector<uint32_t> m_next;
+
+    /// Head of the list of buffers released since the last acquire
+    std::atomic<uint32_t> m_released{none};
+};
+} // namespace chunkie
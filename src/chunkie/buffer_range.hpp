@@ -0,0 +1,174 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "object_view.hpp"
+
+namespace chunkie
+{
+/// Lazy range of the buffers of the object set in a serializer.
+///
+/// Every step of the range writes the next buffer of the object into the
+/// same storage, so the buffers are produced one at a time as they are
+/// consumed and nothing else is allocated. A buffer is only valid until the
+/// iterator is incremented.
+///
+///     serializer.set_object(object, size);
+///     for (auto buffer : chunkie::make_buffer_range(serializer, data, 1400))
+///     {
+///         send(buffer.m_data, buffer.m_size);
+///     }
+template <typename Serializer>
+class buffer_range
+{
+public:
+    /// The serializer writing the buffers
+    using serializer_type = Serializer;
+
+    /// typedef
+    using header_type = typename serializer_type::header_type;
+
+    /// The buffers of the range
+    using value_type = object_view<header_type>;
+
+    /// Input iterator over the buffers
+    class iterator
+    {
+    public:
+        /// Iterator traits
+        using iterator_category = std::input_iterator_tag;
+        using value_type = buffer_range::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+    public:
+        explicit iterator(buffer_range* range = nullptr) : m_range(range)
+        {
+        }
+
+        /// @return the current buffer
+        reference operator*() const
+        {
+            assert(!done() && "Dereferencing the end of the range");
+            return m_range->m_buffer;
+        }
+
+        /// @return the current buffer
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        /// Write the next buffer
+        iterator& operator++()
+        {
+            assert(!done() && "Incrementing the end of the range");
+            m_range->advance();
+            return *this;
+        }
+
+        /// Write the next buffer
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return done() == other.done();
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        /// @return true if all buffers have been written
+        bool done() const
+        {
+            return m_range == nullptr || m_range->m_buffer.m_size == 0;
+        }
+
+    private:
+        /// The range
+        buffer_range* m_range;
+    };
+
+public:
+    /// @param serializer the serializer with an object set
+    /// @param data the storage every buffer is written to
+    /// @param max_buffer_size the size of the storage, larger than the
+    ///        headers of a buffer
+    buffer_range(serializer_type& serializer, uint8_t* data,
+                 header_type max_buffer_size) :
+        m_serializer(serializer),
+        m_data(data), m_max_buffer_size(max_buffer_size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+    }
+
+    /// Write the first buffer
+    /// @return the iterator at the first buffer, may only be called once
+    iterator begin()
+    {
+        advance();
+        return iterator(this);
+    }
+
+    /// @return the end iterator
+    iterator end()
+    {
+        return iterator();
+    }
+
+private:
+    /// Write the next buffer, or mark the range done if the object has been
+    /// processed
+    void advance()
+    {
+        if (m_serializer.object_proccessed())
+        {
+            m_buffer = {m_data, 0};
+            return;
+        }
+
+        auto size = std::min<header_type>(
+            m_max_buffer_size, m_serializer.max_write_buffer_size());
+        m_serializer.write_buffer(m_data, size);
+        m_buffer = {m_data, size};
+    }
+
+private:
+    /// The serializer
+    serializer_type& m_serializer;
+
+    /// The storage of the buffers
+    uint8_t* m_data;
+
+    /// The size of the storage
+    header_type m_max_buffer_size;
+
+    /// The current buffer, empty when the range is done
+    value_type m_buffer{nullptr, 0};
+};
+
+/// @return a buffer_range over the object set in the serializer
+template <typename Serializer>
+buffer_range<Serializer>
+make_buffer_range(Serializer& serializer, uint8_t* data,
+                  typename Serializer::header_type max_buffer_size)
+{
+    return buffer_range<Serializer>(serializer, data, max_buffer_size);
+}
+} // namespace chunkie
@@ -0,0 +1,400 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <endian/big_endian.hpp>
+
+#include "error.hpp"
+#include "io_uring_queue.hpp"
+
+namespace chunkie
+{
+/// Replays the buffers recorded by a chunk_file_writer.
+///
+/// The file is read in large batches. With io_uring the next batch is read
+/// ahead while the buffers of the current batch are consumed, without
+/// io_uring each batch is read with a single blocking pread. Buffers are
+/// returned in place, pointing into the batch, and can be passed straight to
+/// deserializer::set_buffer.
+///
+/// Available on POSIX platforms.
+class chunk_file_reader
+{
+public:
+    /// The size of the length prefix of every record
+    static const std::size_t record_header_size = 4;
+
+public:
+    chunk_file_reader() = default;
+    chunk_file_reader(const chunk_file_reader&) = delete;
+    chunk_file_reader& operator=(const chunk_file_reader&) = delete;
+
+    ~chunk_file_reader()
+    {
+        if (is_open())
+        {
+            close();
+        }
+    }
+
+    /// Open a file for reading
+    /// @param path the path of the file
+    /// @param batch_size the size of each read batch in bytes, must be at
+    ///        least the size of the largest record
+    void open(const std::string& path, std::size_t batch_size,
+              std::error_code& error)
+    {
+        assert(!is_open() && "File already open");
+        assert(batch_size > record_header_size && "Batch too small");
+
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return;
+        }
+
+        m_batch_size = batch_size;
+        m_error = std::error_code();
+
+        for (auto& b : m_batches)
+        {
+            b.m_data.resize(batch_size);
+        }
+
+        // The batches may have moved, so they are registered again
+        if (m_queue.is_initialized() || m_queue.init(batch_count))
+        {
+            register_batches();
+        }
+
+        start(0, 0);
+    }
+
+    /// @return true if a file is open
+    bool is_open() const
+    {
+        return m_fd >= 0;
+    }
+
+    /// @return true if batches are read through io_uring
+    bool uses_io_uring() const
+    {
+        return m_queue.is_initialized();
+    }
+
+    /// @return true if the batches are registered with io_uring, allowing
+    ///         fixed buffer reads
+    bool uses_registered_buffers() const
+    {
+        return m_registered;
+    }
+
+    /// Read the next buffer. The returned data is valid until the next call.
+    /// @param data set to point to the buffer
+    /// @param size set to the size of the buffer
+    /// @return false at the end of the file or on error
+    bool read_buffer(const uint8_t*& data, std::size_t& size,
+                     std::error_code& error)
+    {
+        assert(is_open() && "File not open");
+
+        while (!m_error)
+        {
+            if (m_current < batch_count)
+            {
+                auto& b = m_batches[m_current];
+                if (b.m_position < b.m_complete)
+                {
+                    size = endian::big_endian::get<uint32_t>(
+                        b.m_data.data() + b.m_position);
+                    data = b.m_data.data() + b.m_position + record_header_size;
+                    b.m_position += record_header_size + size;
+                    return true;
+                }
+
+                // A batch without data marks the end of the file
+                if (b.m_size == 0)
+                {
+                    return false;
+                }
+            }
+
+            next_batch();
+        }
+
+        error = m_error;
+        return false;
+    }
+
+    /// Continue reading from the record starting at the given file offset,
+    /// such as an offset returned by chunk_file_writer::offset(). Any error
+    /// from reading at the previous position is cleared.
+    void seek(uint64_t offset)
+    {
+        assert(is_open() && "File not open");
+
+        for (std::size_t i = 0; i < batch_count; ++i)
+        {
+            wait(i);
+        }
+
+        m_error = std::error_code();
+        m_current = batch_count;
+        start(0, offset);
+    }
+
+    /// Close the file
+    void close()
+    {
+        assert(is_open() && "File not open");
+
+        for (std::size_t i = 0; i < batch_count; ++i)
+        {
+            wait(i);
+        }
+
+        ::close(m_fd);
+        m_fd = -1;
+        m_current = batch_count;
+    }
+
+private:
+    /// The number of batches, one being consumed and one being read ahead
+    static const std::size_t batch_count = 2;
+
+    /// A batch of records read with a single operation
+    struct batch
+    {
+        std::vector<uint8_t> m_data;
+        uint64_t m_file_offset = 0;
+        std::size_t m_size = 0;
+        std::size_t m_complete = 0;
+        std::size_t m_position = 0;
+        bool m_in_flight = false;
+    };
+
+    /// Register the batches with io_uring for fixed reads
+    void register_batches()
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_registered)
+        {
+            m_queue.unregister_buffers();
+        }
+
+        iovec buffers[batch_count];
+        for (std::size_t i = 0; i < batch_count; ++i)
+        {
+            buffers[i].iov_base = m_batches[i].m_data.data();
+            buffers[i].iov_len = m_batches[i].m_data.size();
+        }
+        m_registered = m_queue.register_buffers(buffers, batch_count);
+#endif
+    }
+
+    /// Make the batch after the current one the current batch
+    void next_batch()
+    {
+        std::size_t next =
+            m_current < batch_count ? (m_current + 1) % batch_count : 0;
+
+        wait(next);
+        if (m_error)
+        {
+            return;
+        }
+
+        auto& b = m_batches[next];
+        b.m_position = 0;
+        b.m_complete = complete_records(b);
+        m_current = next;
+
+        if (m_error || b.m_size == 0)
+        {
+            return;
+        }
+
+        // Read ahead from the first record not completely in this batch
+        start((next + 1) % batch_count, b.m_file_offset + b.m_complete);
+        submit_queued();
+    }
+
+    /// @return the number of bytes at the start of the batch occupied by
+    ///         complete records
+    std::size_t complete_records(const batch& b)
+    {
+        std::size_t complete = 0;
+
+        while (complete + record_header_size <= b.m_size)
+        {
+            std::size_t size =
+                endian::big_endian::get<uint32_t>(b.m_data.data() + complete);
+
+            if (complete + record_header_size + size > b.m_size)
+            {
+                break;
+            }
+
+            complete += record_header_size + size;
+        }
+
+        if (complete == 0 && b.m_size > 0)
+        {
+            // Not even a single record fits. If the batch was filled the
+            // record is too large, otherwise the file ends inside it.
+            m_error = b.m_size == m_batch_size ? error::record_too_large
+                                               : error::truncated_record;
+        }
+
+        return complete;
+    }
+
+    /// Queue a read of a batch from the given file offset, or read it
+    /// directly without io_uring
+    void start(std::size_t index, uint64_t file_offset)
+    {
+        auto& b = m_batches[index];
+        assert(!b.m_in_flight);
+
+        b.m_file_offset = file_offset;
+        b.m_size = 0;
+        b.m_complete = 0;
+        b.m_position = 0;
+
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_queue.is_initialized())
+        {
+            int result = m_queue.queue_read(
+                m_fd, b.m_data.data(), (uint32_t)m_batch_size, file_offset,
+                m_registered ? (int)index : -1, index);
+
+            if (result == 0)
+            {
+                b.m_in_flight = true;
+                return;
+            }
+        }
+#endif
+
+        read_remaining(b, 0);
+    }
+
+    /// Hand the queued reads to the kernel
+    void submit_queued()
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_queue.is_initialized())
+        {
+            int status = m_queue.submit();
+            if (status < 0 && !m_error)
+            {
+                m_error = std::error_code(-status, std::generic_category());
+            }
+        }
+#endif
+    }
+
+    /// Wait until a batch has been read
+    void wait(std::size_t index)
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        while (m_batches[index].m_in_flight)
+        {
+            uint64_t completed = 0;
+            int32_t result = 0;
+
+            int status = m_queue.wait(completed, result);
+            if (status < 0)
+            {
+                m_error = std::error_code(-status, std::generic_category());
+                m_batches[index].m_in_flight = false;
+                return;
+            }
+
+            assert(completed < batch_count);
+            auto& b = m_batches[completed];
+            b.m_in_flight = false;
+
+            if (result < 0)
+            {
+                m_error = std::error_code(-result, std::generic_category());
+            }
+            else if (result > 0)
+            {
+                // A short read does not necessarily mean the end of the file
+                read_remaining(b, (std::size_t)result);
+            }
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    /// Read into the remainder of a batch with pread until it is full or the
+    /// end of the file is reached
+    void read_remaining(batch& b, std::size_t size)
+    {
+        while (size < m_batch_size)
+        {
+            auto result = ::pread(m_fd, b.m_data.data() + size,
+                                  m_batch_size - size,
+                                  (off_t)(b.m_file_offset + size));
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                m_error = std::error_code(errno, std::generic_category());
+                break;
+            }
+
+            if (result == 0)
+            {
+                break;
+            }
+
+            size += (std::size_t)result;
+        }
+
+        b.m_size = size;
+    }
+
+private:
+    /// The file descriptor
+    int m_fd = -1;
+
+    /// The io_uring queue, if available
+    io_uring_queue m_queue;
+
+    /// True if the batches are registered with the queue
+    bool m_registered = false;
+
+    /// The batches
+    batch m_batches[batch_count];
+
+    /// The batch being consumed, batch_count if none
+    std::size_t m_current = batch_count;
+
+    /// The size of each batch
+    std::size_t m_batch_size = 0;
+
+    /// The first error encountered while reading
+    std::error_code m_error;
+};
+} // namespace chunkie
@@ -0,0 +1,392 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <endian/big_endian.hpp>
+
+#include "io_uring_queue.hpp"
+
+namespace chunkie
+{
+/// Records serialized buffers to a file.
+///
+/// Every buffer is stored as a record consisting of a 4 byte big endian
+/// length followed by the buffer. Records are staged in a few large batches
+/// which the serializer writes into directly through prepare() and commit().
+/// Full batches are written with io_uring where available, so recording
+/// continues in the next batch while the previous one is written. Without
+/// io_uring each batch is written with a single blocking pwrite.
+///
+/// Available on POSIX platforms.
+class chunk_file_writer
+{
+public:
+    /// The size of the length prefix of every record
+    static const std::size_t record_header_size = 4;
+
+    /// The number of batches that can be in use at the same time
+    static const std::size_t batch_count = 4;
+
+public:
+    chunk_file_writer() = default;
+    chunk_file_writer(const chunk_file_writer&) = delete;
+    chunk_file_writer& operator=(const chunk_file_writer&) = delete;
+
+    ~chunk_file_writer()
+    {
+        if (is_open())
+        {
+            std::error_code error;
+            close(error);
+        }
+    }
+
+    /// Create or truncate the file and prepare for writing
+    /// @param path the path of the file
+    /// @param batch_size the size of each batch in bytes, a record must fit
+    ///        in a single batch
+    void open(const std::string& path, std::size_t batch_size,
+              std::error_code& error)
+    {
+        assert(!is_open() && "File already open");
+        assert(batch_size > record_header_size && "Batch too small");
+
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return;
+        }
+
+        m_batch_size = batch_size;
+        m_offset = 0;
+        m_file_offset = 0;
+        m_current = 0;
+        m_error = std::error_code();
+
+        for (auto& b : m_batches)
+        {
+            b.m_data.resize(batch_size);
+            b.m_size = 0;
+            b.m_in_flight = false;
+        }
+
+        // The batches may have moved, so they are registered again
+        if (m_queue.is_initialized() || m_queue.init(batch_count))
+        {
+            register_batches();
+        }
+    }
+
+    /// @return true if a file is open
+    bool is_open() const
+    {
+        return m_fd >= 0;
+    }
+
+    /// @return true if batches are written through io_uring
+    bool uses_io_uring() const
+    {
+        return m_queue.is_initialized();
+    }
+
+    /// @return true if the batches are registered with io_uring, allowing
+    ///         fixed buffer writes
+    bool uses_registered_buffers() const
+    {
+        return m_registered;
+    }
+
+    /// Reserve space for a record of up to size bytes
+    /// @return pointer to write the buffer to, or nullptr on error
+    uint8_t* prepare(std::size_t size, std::error_code& error)
+    {
+        assert(is_open() && "File not open");
+        assert(size + record_header_size <= m_batch_size &&
+               "Record larger than a batch");
+
+        if (m_batches[m_current].m_size + record_header_size + size >
+            m_batch_size)
+        {
+            submit(m_current);
+            m_current = (m_current + 1) % batch_count;
+            wait(m_current);
+        }
+
+        if (m_error)
+        {
+            error = m_error;
+            return nullptr;
+        }
+
+        m_prepared = size;
+        auto& b = m_batches[m_current];
+        return b.m_data.data() + b.m_size + record_header_size;
+    }
+
+    /// Complete the record reserved by the last prepare()
+    /// @param size the number of bytes written, at most the prepared size
+    void commit(std::size_t size)
+    {
+        assert(size <= m_prepared && "More bytes than prepared");
+        assert(size <= 0xFFFFFFFFU && "Record too large");
+
+        auto& b = m_batches[m_current];
+        endian::big_endian::put<uint32_t>((uint32_t)size,
+                                          b.m_data.data() + b.m_size);
+
+        b.m_size += record_header_size + size;
+        m_offset += record_header_size + size;
+        m_prepared = 0;
+    }
+
+    /// Copy a buffer into a record
+    void write(const uint8_t* data, std::size_t size, std::error_code& error)
+    {
+        assert(data != nullptr && "Null pointer provided");
+
+        uint8_t* record = prepare(size, error);
+        if (record == nullptr)
+        {
+            return;
+        }
+
+        std::copy(data, data + size, record);
+        commit(size);
+    }
+
+    /// Start writing the records staged so far, without waiting for the
+    /// write to complete
+    void flush(std::error_code& error)
+    {
+        assert(is_open() && "File not open");
+
+        submit(m_current);
+        m_current = (m_current + 1) % batch_count;
+
+        // Waiting for the next batch submits the queued write in the same
+        // system call, otherwise it is submitted on its own
+        wait(m_current);
+        submit_queued();
+
+        if (m_error)
+        {
+            error = m_error;
+        }
+    }
+
+    /// Write all staged records, wait for them and close the file
+    void close(std::error_code& error)
+    {
+        assert(is_open() && "File not open");
+
+        submit(m_current);
+        for (std::size_t i = 0; i < batch_count; ++i)
+        {
+            wait(i);
+        }
+
+        if (::close(m_fd) != 0 && !m_error)
+        {
+            m_error = std::error_code(errno, std::generic_category());
+        }
+        m_fd = -1;
+
+        if (m_error)
+        {
+            error = m_error;
+        }
+    }
+
+    /// @return the file offset at which the next record will be stored
+    uint64_t offset() const
+    {
+        return m_offset;
+    }
+
+private:
+    /// A batch of records written with a single operation
+    struct batch
+    {
+        std::vector<uint8_t> m_data;
+        std::size_t m_size = 0;
+        uint64_t m_file_offset = 0;
+        bool m_in_flight = false;
+    };
+
+    /// Register the batches with io_uring for fixed writes
+    void register_batches()
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_registered)
+        {
+            m_queue.unregister_buffers();
+        }
+
+        iovec buffers[batch_count];
+        for (std::size_t i = 0; i < batch_count; ++i)
+        {
+            buffers[i].iov_base = m_batches[i].m_data.data();
+            buffers[i].iov_len = m_batches[i].m_data.size();
+        }
+        m_registered = m_queue.register_buffers(buffers, batch_count);
+#endif
+    }
+
+    /// Queue a write of a batch, or write it directly without io_uring
+    void submit(std::size_t index)
+    {
+        auto& b = m_batches[index];
+        if (b.m_size == 0 || m_error)
+        {
+            b.m_size = 0;
+            return;
+        }
+
+        b.m_file_offset = m_file_offset;
+        m_file_offset += b.m_size;
+
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_queue.is_initialized())
+        {
+            int result = m_queue.queue_write(
+                m_fd, b.m_data.data(), (uint32_t)b.m_size, b.m_file_offset,
+                m_registered ? (int)index : -1, index);
+
+            if (result == 0)
+            {
+                b.m_in_flight = true;
+                return;
+            }
+        }
+#endif
+
+        write_remaining(b, 0);
+        b.m_size = 0;
+    }
+
+    /// Hand the queued writes to the kernel
+    void submit_queued()
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        if (m_queue.is_initialized())
+        {
+            int status = m_queue.submit();
+            if (status < 0 && !m_error)
+            {
+                m_error = std::error_code(-status, std::generic_category());
+            }
+        }
+#endif
+    }
+
+    /// Wait until a batch is no longer being written
+    void wait(std::size_t index)
+    {
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+        while (m_batches[index].m_in_flight)
+        {
+            uint64_t completed = 0;
+            int32_t result = 0;
+
+            int status = m_queue.wait(completed, result);
+            if (status < 0)
+            {
+                m_error = std::error_code(-status, std::generic_category());
+                m_batches[index].m_in_flight = false;
+                m_batches[index].m_size = 0;
+                return;
+            }
+
+            assert(completed < batch_count);
+            auto& b = m_batches[completed];
+            b.m_in_flight = false;
+
+            if (result < 0)
+            {
+                if (!m_error)
+                {
+                    m_error =
+                        std::error_code(-result, std::generic_category());
+                }
+            }
+            else if ((std::size_t)result < b.m_size)
+            {
+                write_remaining(b, result);
+            }
+
+            b.m_size = 0;
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    /// Write the remainder of a batch with pwrite
+    void write_remaining(const batch& b, std::size_t written)
+    {
+        while (written < b.m_size && !m_error)
+        {
+            auto result = ::pwrite(m_fd, b.m_data.data() + written,
+                                   b.m_size - written,
+                                   (off_t)(b.m_file_offset + written));
+
+            if (result < 0)
+            {
+                if (errno != EINTR)
+                {
+                    m_error = std::error_code(errno, std::generic_category());
+                }
+                continue;
+            }
+
+            written += (std::size_t)result;
+        }
+    }
+
+private:
+    /// The file descriptor
+    int m_fd = -1;
+
+    /// The io_uring queue, if available
+    io_uring_queue m_queue;
+
+    /// True if the batches are registered with the queue
+    bool m_registered = false;
+
+    /// The batches
+    batch m_batches[batch_count];
+
+    /// The batch currently being filled
+    std::size_t m_current = 0;
+
+    /// The size of each batch
+    std::size_t m_batch_size = 0;
+
+    /// The size reserved by the last prepare()
+    std::size_t m_prepared = 0;
+
+    /// The file offset of the next record
+    uint64_t m_offset = 0;
+
+    /// The file offset of the next batch
+    uint64_t m_file_offset = 0;
+
+    /// The first error encountered while writing
+    std::error_code m_error;
+};
+} // namespace chunkie
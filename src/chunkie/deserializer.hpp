@@ -7,23 +7,39 @@
 
 #include <algorithm>
 #include <memory>
+#include <system_error>
 
 #include <endian/big_endian.hpp>
 #include <endian/stream_reader.hpp>
 
 #include <bitter/msb0_reader.hpp>
 
+#include "error.hpp"
+#include "no_extension.hpp"
+#include "standard_copy.hpp"
+
 namespace chunkie
 {
 /// The object deserializer reads the header of serialized data and deserializes
 /// it accordingly.
-template <typename HeaderType = uint32_t>
+///
+/// The Extension must match the start header extension of the serializer.
+/// The CopyPolicy selects how data is copied from the buffers to the
+/// objects.
+template <typename HeaderType = uint32_t, typename Extension = no_extension,
+          typename CopyPolicy = standard_copy>
 class deserializer
 {
 public:
     /// Type def
     using header_type = HeaderType;
 
+    /// The start header extension
+    using extension_type = Extension;
+
+    /// The copy policy
+    using copy_policy_type = CopyPolicy;
+
     /// The size of the header
     static const header_type header_size;
 
@@ -47,6 +63,36 @@ public:
         read_header();
     }
 
+    /// Read from an untrusted buffer. buffers must be read in-order.
+    ///
+    /// The buffer and its headers are validated while they are parsed, also
+    /// when assertions are disabled. A malformed buffer is dropped, together
+    /// with the partially read object, and the deserializer continues with
+    /// the next buffer.
+    /// @param data the buffer to read
+    /// @param size the size of the buffer
+    /// @param error set to error::invalid_buffer if the buffer is malformed
+    void set_buffer(const uint8_t* data, header_type size,
+                    std::error_code& error)
+    {
+        assert(m_buffer_reader == nullptr && "Previous buffer not proccessed");
+
+        if (data == nullptr || size <= header_size)
+        {
+            error = chunkie::error::invalid_buffer;
+            return;
+        }
+
+        m_buffer_reader =
+            std::make_unique<endian::stream_reader<endian::big_endian>>(data,
+                                                                        size);
+
+        if (!read_header())
+        {
+            error = chunkie::error::invalid_buffer;
+        }
+    }
+
     /// @returns true if all data in the set buffer have been processed
     bool buffer_proccessed() const
     {
@@ -64,8 +110,42 @@ public:
 
     /// Writes available bytes to the given pointer.
     void write_to_object(uint8_t* object)
+    {
+        write_data(object);
+    }
+
+    /// Writes available bytes to the given pointer, for buffers set with
+    /// the validating set_buffer().
+    /// @param object the object, at least object_size() bytes
+    /// @param error set to error::invalid_buffer if the rest of the buffer
+    ///        is malformed
+    void write_to_object(uint8_t* object, std::error_code& error)
+    {
+        if (!write_data(object))
+        {
+            error = chunkie::error::invalid_buffer;
+        }
+    }
+
+    /// @return true if the final part of an object was written
+    bool object_completed() const
+    {
+        return m_object_completed;
+    }
+
+    /// @return the start header extension of the object being parsed
+    const extension_type& extension() const
+    {
+        return m_extension;
+    }
+
+private:
+    /// Writes available bytes to the object and reads the next header
+    /// @return false if the rest of the buffer is malformed
+    bool write_data(uint8_t* object)
     {
         assert(object != nullptr && "Null pointer provided");
+        assert(!buffer_proccessed() && "No buffer set");
 
         m_object_completed = false;
 
@@ -73,7 +153,10 @@ public:
             (header_type)m_buffer_reader->remaining_size(), m_object_remaining);
 
         auto offset = m_object_size - m_object_remaining;
-        m_buffer_reader->read(object + offset, bytes);
+        copy_policy_type::copy(object + offset,
+                               m_buffer_reader->remaining_data(), bytes,
+                               m_object_size);
+        m_buffer_reader->skip(bytes);
 
         m_object_remaining -= bytes;
 
@@ -81,57 +164,73 @@ public:
         {
             m_object_size = 0;
             m_object_completed = true;
+            m_extension.on_object_completed();
         }
 
         if (m_buffer_reader->remaining_size() > sizeof(header_type))
         {
-            read_header();
-            return;
+            return read_header();
         }
 
         m_buffer_reader = nullptr;
+        return true;
     }
 
-    /// @return true if the final part of an object was written
-    bool object_completed() const
-    {
-        return m_object_completed;
-    }
-
-private:
-    /// Reads the header of a data buffer
-    void read_header()
+    /// Reads headers until object data is found or the buffer is processed
+    /// @return false if the buffer is malformed, the buffer is then dropped
+    bool read_header()
     {
-        auto header_data = m_buffer_reader->read<header_type>();
-        auto header = header_reader(header_data);
-        auto start = header.template field<0>().template as<bool>();
-        auto remaining = header.template field<1>().template as<header_type>();
-
-        // Start of new object
-        if (start == true)
-        {
-            m_object_size = remaining;
-            m_object_remaining = remaining;
-            return;
-        }
-
-        // Continue reading object
-        if ((remaining == m_object_remaining) && (remaining != 0))
-        {
-            return;
-        }
-
-        // Read next header if inside the current buffer
-        if (m_buffer_reader->remaining_size() > remaining + sizeof(header_type))
+        while (true)
         {
-            m_buffer_reader->skip(remaining);
-
-            read_header();
-            return;
+            auto header_data = m_buffer_reader->read<header_type>();
+            auto header = header_reader(header_data);
+            auto start = header.template field<0>().template as<bool>();
+            auto remaining =
+                header.template field<1>().template as<header_type>();
+
+            // Start of new object
+            if (start == true)
+            {
+                // The serializer never writes empty objects or a truncated
+                // start header extension
+                if (remaining == 0 || m_buffer_reader->remaining_size() <
+                                          extension_type::size)
+                {
+                    m_object_size = 0;
+                    m_object_remaining = 0;
+                    m_buffer_reader = nullptr;
+                    return false;
+                }
+
+                if (extension_type::size > 0)
+                {
+                    m_extension.read(m_buffer_reader->remaining_data());
+                    m_buffer_reader->skip(extension_type::size);
+                }
+
+                m_object_size = remaining;
+                m_object_remaining = remaining;
+                return true;
+            }
+
+            // Continue reading object
+            if ((remaining == m_object_remaining) && (remaining != 0))
+            {
+                return true;
+            }
+
+            // Read next header if inside the current buffer
+            if (m_buffer_reader->remaining_size() >
+                remaining + sizeof(header_type))
+            {
+                m_buffer_reader->skip(remaining);
+                continue;
+            }
+
+            // Any remaining data do not contain a header to be read
+            m_buffer_reader = nullptr;
+            return true;
         }
-
-        // Any remaining data do not contain a header to be read
-        m_buffer_reader = nullptr;
     }
 
 private:
@@ -147,8 +246,11 @@ private:
 
     /// Bool for determining completion
     bool m_object_completed = false;
+
+    /// The start header extension of the current object
+    extension_type m_extension;
 };
 
-template <class T>
-const T deserializer<T>::header_size = sizeof(T);
+template <class T, class E, class C>
+const T deserializer<T, E, C>::header_size = sizeof(T);
 } // namespace chunkie
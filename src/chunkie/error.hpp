@@ -0,0 +1,79 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <system_error>
+
+namespace chunkie
+{
+/// Error codes reported by chunkie
+enum class error
+{
+    no_error = 0,
+    /// A record in a chunk file is larger than the read batch
+    record_too_large,
+    /// A chunk file ends in the middle of a record
+    truncated_record,
+    /// A file is not an archive or its index is damaged
+    invalid_archive,
+    /// A buffer is too small or its headers are inconsistent
+    invalid_buffer,
+    /// A shared memory segment is not a ring or has been damaged
+    invalid_ring
+};
+
+/// The error category of chunkie errors
+class error_category_type : public std::error_category
+{
+public:
+    const char* name() const noexcept override
+    {
+        return "chunkie";
+    }
+
+    std::string message(int value) const override
+    {
+        switch (static_cast<error>(value))
+        {
+        case error::no_error:
+            return "no error";
+        case error::record_too_large:
+            return "record larger than the read batch";
+        case error::truncated_record:
+            return "file ends in the middle of a record";
+        case error::invalid_archive:
+            return "not a valid archive";
+        case error::invalid_buffer:
+            return "malformed buffer";
+        case error::invalid_ring:
+            return "not a valid shared memory ring";
+        }
+        return "unknown error";
+    }
+};
+
+/// @return the error category of chunkie errors
+inline const std::error_category& error_category()
+{
+    static error_category_type category;
+    return category;
+}
+
+/// @return an error_code for the given chunkie error
+inline std::error_code make_error_code(error value)
+{
+    return std::error_code(static_cast<int>(value), error_category());
+}
+} // namespace chunkie
+
+namespace std
+{
+template <>
+struct is_error_code_enum<chunkie::error> : public true_type
+{
+};
+} // namespace std
@@ -0,0 +1,148 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <endian/big_endian.hpp>
+
+#include "fixed_offset.hpp"
+#include "standard_copy.hpp"
+
+namespace chunkie
+{
+/// Deserializer for the buffers written by a fixed_serializer with the same
+/// ObjectSize and Aligned parameters.
+///
+/// The object boundaries are computed from the offset in the buffer header,
+/// or are at every multiple of ObjectSize for aligned buffers. If a buffer
+/// continues a different object than the one being reassembled, because a
+/// buffer was lost, the partial object is dropped and the data up to the
+/// next object boundary is skipped.
+template <std::size_t ObjectSize, bool Aligned = false,
+          typename CopyPolicy = standard_copy>
+class fixed_deserializer
+{
+public:
+    /// The size of every object
+    static const std::size_t object_size = ObjectSize;
+
+    /// The type of the buffer header
+    using header_type = fixed_offset<ObjectSize>;
+
+    /// The copy policy
+    using copy_policy_type = CopyPolicy;
+
+    /// Size of the header, zero if the buffers are aligned to the objects
+    static const std::size_t header_size = Aligned ? 0 : sizeof(header_type);
+
+    static_assert(ObjectSize > 0, "Objects can not be empty");
+
+public:
+    /// Read from a buffer. buffers must be read in-order
+    /// @param data the buffer to read
+    /// @param size the size of the buffer
+    void set_buffer(const uint8_t* data, std::size_t size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(size > header_size && "Buffer smaller than header");
+        assert((!Aligned || size % ObjectSize == 0) &&
+               "Aligned buffers must hold whole objects");
+        assert(buffer_proccessed() && "Previous buffer not proccessed");
+
+        m_buffer = data + header_size;
+        m_buffer_remaining = size - header_size;
+
+        if (header_size == 0)
+        {
+            return;
+        }
+
+        std::size_t offset = endian::big_endian::get<header_type>(data);
+        if (offset == m_object_offset)
+        {
+            return;
+        }
+
+        // The buffer continues another object, skip to the next one
+        m_object_offset = 0;
+        if (offset != 0)
+        {
+            auto bytes =
+                std::min<std::size_t>(m_buffer_remaining, ObjectSize - offset);
+            m_buffer += bytes;
+            m_buffer_remaining -= bytes;
+        }
+
+        if (m_buffer_remaining == 0)
+        {
+            m_buffer = nullptr;
+        }
+    }
+
+    /// @returns true if all data in the set buffer have been processed
+    bool buffer_proccessed() const
+    {
+        return m_buffer == nullptr;
+    }
+
+    /// Writes available bytes to the given object
+    /// @param object the object of ObjectSize bytes
+    void write_to_object(uint8_t* object)
+    {
+        assert(object != nullptr && "Null pointer provided");
+        assert(!buffer_proccessed() && "No buffer set");
+
+        auto bytes = std::min<std::size_t>(m_buffer_remaining,
+                                           ObjectSize - m_object_offset);
+
+        copy_policy_type::copy(object + m_object_offset, m_buffer, bytes,
+                               ObjectSize);
+        m_buffer += bytes;
+        m_buffer_remaining -= bytes;
+        m_object_offset += bytes;
+
+        m_object_completed = m_object_offset == ObjectSize;
+        if (m_object_completed)
+        {
+            m_object_offset = 0;
+        }
+
+        if (m_buffer_remaining == 0)
+        {
+            m_buffer = nullptr;
+        }
+    }
+
+    /// @return true if the final part of an object was written
+    bool object_completed() const
+    {
+        return m_object_completed;
+    }
+
+private:
+    /// The unread data of the current buffer
+    const uint8_t* m_buffer = nullptr;
+
+    /// The number of unread bytes in the current buffer
+    std::size_t m_buffer_remaining = 0;
+
+    /// The number of bytes of the current object already written
+    std::size_t m_object_offset = 0;
+
+    /// Bool for determining completion
+    bool m_object_completed = false;
+};
+
+template <std::size_t S, bool A, class C>
+const std::size_t fixed_deserializer<S, A, C>::object_size;
+
+template <std::size_t S, bool A, class C>
+const std::size_t fixed_deserializer<S, A, C>::header_size;
+} // namespace chunkie
@@ -0,0 +1,23 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace chunkie
+{
+/// The smallest unsigned type holding the offsets 0 to ObjectSize - 1 within
+/// an object of ObjectSize bytes.
+template <std::size_t ObjectSize>
+using fixed_offset = typename std::conditional<
+    (ObjectSize <= 0x100), uint8_t,
+    typename std::conditional<
+        (ObjectSize <= 0x10000), uint16_t,
+        typename std::conditional<(ObjectSize <= 0x100000000ULL), uint32_t,
+                                  uint64_t>::type>::type>::type;
+} // namespace chunkie
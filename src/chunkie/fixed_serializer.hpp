@@ -0,0 +1,157 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <endian/big_endian.hpp>
+
+#include "fixed_offset.hpp"
+#include "standard_copy.hpp"
+
+namespace chunkie
+{
+/// Serializer for streams of objects which all have the size ObjectSize.
+///
+/// As the object size is known to both sides, the objects are written back
+/// to back without any per object header. Each buffer starts with a single
+/// header holding the offset within the current object of the first byte
+/// in the buffer, which lets the fixed_deserializer find the object
+/// boundaries after a lost buffer. The header is the smallest type holding
+/// the offsets, see fixed_offset.
+///
+/// If Aligned is true the buffers hold whole objects only, and no header is
+/// written at all. Every buffer size must then be a multiple of ObjectSize.
+///
+/// Buffers are filled by setting a buffer and then writing objects to it
+/// until it is full or there are no more objects:
+///
+///     serializer.set_buffer(buffer, 1400);
+///     serializer.set_object(object);
+///     serializer.write();
+///     ...
+///     send(buffer, serializer.buffer_size());
+template <std::size_t ObjectSize, bool Aligned = false,
+          typename CopyPolicy = standard_copy>
+class fixed_serializer
+{
+public:
+    /// The size of every object
+    static const std::size_t object_size = ObjectSize;
+
+    /// The type of the buffer header
+    using header_type = fixed_offset<ObjectSize>;
+
+    /// The copy policy
+    using copy_policy_type = CopyPolicy;
+
+    /// Size of the header, zero if the buffers are aligned to the objects
+    static const std::size_t header_size = Aligned ? 0 : sizeof(header_type);
+
+    static_assert(ObjectSize > 0, "Objects can not be empty");
+
+public:
+    /// Start writing a new buffer, the header is written immediately
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    void set_buffer(uint8_t* data, std::size_t size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(size > header_size && "Buffer too small for header");
+        assert((!Aligned || size % ObjectSize == 0) &&
+               "Aligned buffers must hold whole objects");
+        assert((!Aligned || object_proccessed()) &&
+               "Aligned buffers must start with a new object");
+
+        if (header_size > 0)
+        {
+            endian::big_endian::put<header_type>(
+                (header_type)((ObjectSize - m_object_remaining) % ObjectSize),
+                data);
+        }
+
+        m_buffer = data;
+        m_buffer_size = size;
+        m_buffer_offset = header_size;
+    }
+
+    /// Set the next object, the previous object must be processed
+    /// @param object the object of ObjectSize bytes
+    void set_object(const uint8_t* object)
+    {
+        assert(object != nullptr && "Null pointer provided");
+        assert(object_proccessed() && "Last object not proccessed");
+
+        m_object = object;
+        m_object_remaining = ObjectSize;
+    }
+
+    /// Write as much of the current object as fits in the buffer
+    void write()
+    {
+        assert(m_buffer != nullptr && "No buffer set");
+        assert(!object_proccessed() && "No object set");
+
+        auto bytes =
+            std::min<std::size_t>(buffer_remaining(), m_object_remaining);
+
+        copy_policy_type::copy(m_buffer + m_buffer_offset,
+                               m_object + ObjectSize - m_object_remaining,
+                               bytes, ObjectSize);
+        m_buffer_offset += bytes;
+        m_object_remaining -= bytes;
+
+        if (m_object_remaining == 0)
+        {
+            m_object = nullptr;
+        }
+    }
+
+    /// @return true if the current object has been completely written
+    bool object_proccessed() const
+    {
+        return m_object == nullptr;
+    }
+
+    /// @return the number of bytes written to the buffer, including the
+    ///         header
+    std::size_t buffer_size() const
+    {
+        return m_buffer_offset;
+    }
+
+    /// @return the number of bytes left in the buffer
+    std::size_t buffer_remaining() const
+    {
+        return m_buffer_size - m_buffer_offset;
+    }
+
+private:
+    /// The current object
+    const uint8_t* m_object = nullptr;
+
+    /// The bytes of the current object not yet written
+    std::size_t m_object_remaining = 0;
+
+    /// The current buffer
+    uint8_t* m_buffer = nullptr;
+
+    /// The size of the current buffer
+    std::size_t m_buffer_size = 0;
+
+    /// The number of bytes written to the current buffer
+    std::size_t m_buffer_offset = 0;
+};
+
+template <std::size_t S, bool A, class C>
+const std::size_t fixed_serializer<S, A, C>::object_size;
+
+template <std::size_t S, bool A, class C>
+const std::size_t fixed_serializer<S, A, C>::header_size;
+} // namespace chunkie
@@ -0,0 +1,349 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_SINGLE_MMAP)
+#define CHUNKIE_IO_URING_AVAILABLE
+#endif
+#endif
+#endif
+
+namespace chunkie
+{
+/// Minimal io_uring submission and completion queue used by the chunk file
+/// writer and reader.
+///
+/// The queue talks to the kernel directly through the io_uring system calls.
+/// Operations are queued without a system call, and all queued operations
+/// are handed to the kernel together by submit(), or by wait() in the same
+/// system call that waits for a completion. On platforms or kernels without io_uring, init() returns false and the
+/// caller falls back to plain pread/pwrite.
+class io_uring_queue
+{
+public:
+    io_uring_queue() = default;
+    io_uring_queue(const io_uring_queue&) = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    ~io_uring_queue()
+    {
+        release();
+    }
+
+#if defined(CHUNKIE_IO_URING_AVAILABLE)
+    /// Set up the queue
+    /// @param entries the number of submission queue entries
+    /// @return false if io_uring is not available
+    bool init(uint32_t entries)
+    {
+        assert(m_fd < 0 && "Queue already initialized");
+
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            return false;
+        }
+        m_fd = fd;
+
+        m_sq_ring_size =
+            params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        m_cq_ring_size =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            if (m_cq_ring_size > m_sq_ring_size)
+            {
+                m_sq_ring_size = m_cq_ring_size;
+            }
+            m_cq_ring_size = 0;
+        }
+
+        m_sq_ring = map(m_sq_ring_size, IORING_OFF_SQ_RING);
+        if (m_sq_ring == nullptr)
+        {
+            release();
+            return false;
+        }
+
+        m_cq_ring = m_sq_ring;
+        if (m_cq_ring_size > 0)
+        {
+            m_cq_ring = map(m_cq_ring_size, IORING_OFF_CQ_RING);
+            if (m_cq_ring == nullptr)
+            {
+                release();
+                return false;
+            }
+        }
+
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe*>(
+            (void*)map(m_sqes_size, IORING_OFF_SQES));
+        if (m_sqes == nullptr)
+        {
+            release();
+            return false;
+        }
+
+        m_sq_head = (uint32_t*)(m_sq_ring + params.sq_off.head);
+        m_sq_tail = (uint32_t*)(m_sq_ring + params.sq_off.tail);
+        m_submitted = *m_sq_tail;
+        m_sq_mask = *(uint32_t*)(m_sq_ring + params.sq_off.ring_mask);
+        m_sq_array = (uint32_t*)(m_sq_ring + params.sq_off.array);
+        m_sq_entries = params.sq_entries;
+
+        m_cq_head = (uint32_t*)(m_cq_ring + params.cq_off.head);
+        m_cq_tail = (uint32_t*)(m_cq_ring + params.cq_off.tail);
+        m_cq_mask = *(uint32_t*)(m_cq_ring + params.cq_off.ring_mask);
+        m_cqes = (io_uring_cqe*)(m_cq_ring + params.cq_off.cqes);
+
+        return true;
+    }
+
+    /// Register buffers so they can be used with fixed reads and writes,
+    /// avoiding the page mapping on every operation
+    /// @return false if the buffers could not be registered, e.g. because
+    ///         of the locked memory limit
+    bool register_buffers(const iovec* buffers, uint32_t count)
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+        return syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS,
+                       buffers, count) == 0;
+    }
+
+    /// Unregister previously registered buffers
+    void unregister_buffers()
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+        syscall(__NR_io_uring_register, m_fd, IORING_UNREGISTER_BUFFERS,
+                nullptr, 0);
+    }
+
+    /// Queue a write of data to the file at the given offset, it is started
+    /// by the next submit() or wait()
+    /// @param buffer_index the index of a registered buffer containing data,
+    ///        or -1 if the data is not in a registered buffer
+    /// @return -EBUSY if the submission queue is full
+    int queue_write(int fd, const uint8_t* data, uint32_t size,
+                    uint64_t offset, int buffer_index, uint64_t user_data)
+    {
+        return queue(buffer_index < 0 ? IORING_OP_WRITE
+                                      : IORING_OP_WRITE_FIXED,
+                     fd, data, size, offset, buffer_index, user_data);
+    }
+
+    /// Queue a read into data from the file at the given offset, it is
+    /// started by the next submit() or wait()
+    /// @param buffer_index the index of a registered buffer containing data,
+    ///        or -1 if the data is not in a registered buffer
+    /// @return -EBUSY if the submission queue is full
+    int queue_read(int fd, uint8_t* data, uint32_t size, uint64_t offset,
+                   int buffer_index, uint64_t user_data)
+    {
+        return queue(buffer_index < 0 ? IORING_OP_READ : IORING_OP_READ_FIXED,
+                     fd, data, size, offset, buffer_index, user_data);
+    }
+
+    /// @return the number of queued operations not yet submitted
+    uint32_t pending() const
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+        return *m_sq_tail - m_submitted;
+    }
+
+    /// Hand all queued operations to the kernel
+    /// @return a negative errno on failure
+    int submit()
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+
+        while (pending() > 0)
+        {
+            int result = enter(0, 0);
+            if (result < 0)
+            {
+                return result;
+            }
+        }
+        return 0;
+    }
+
+    /// Wait for the next completion, submitting the queued operations in the
+    /// same system call
+    /// @param user_data set to the user data of the completed operation
+    /// @param result set to the result of the operation
+    /// @return a negative errno if waiting failed
+    int wait(uint64_t& user_data, int32_t& result)
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+
+        while (true)
+        {
+            uint32_t head = *m_cq_head;
+            uint32_t tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+
+            if (head != tail)
+            {
+                const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+                user_data = cqe.user_data;
+                result = cqe.res;
+                __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+                return 0;
+            }
+
+            int status = enter(1, IORING_ENTER_GETEVENTS);
+            if (status < 0)
+            {
+                return status;
+            }
+        }
+    }
+
+private:
+    /// Map a region of the queue into memory
+    uint8_t* map(std::size_t size, uint64_t offset)
+    {
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, m_fd, (off_t)offset);
+        return data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+    }
+
+    /// Fill a submission queue entry
+    int queue(uint8_t opcode, int fd, const uint8_t* data, uint32_t size,
+               uint64_t offset, int buffer_index, uint64_t user_data)
+    {
+        assert(m_fd >= 0 && "Queue not initialized");
+
+        uint32_t tail = *m_sq_tail;
+        uint32_t head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+        if (tail - head >= m_sq_entries)
+        {
+            return -EBUSY;
+        }
+
+        uint32_t index = tail & m_sq_mask;
+        io_uring_sqe& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = (uint64_t)(uintptr_t)data;
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.buf_index = buffer_index < 0 ? 0 : (uint16_t)buffer_index;
+        sqe.user_data = user_data;
+
+        m_sq_array[index] = index;
+        __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    /// Submit the pending operations and optionally wait for completions
+    /// with a single io_uring_enter call
+    /// @return a negative errno on failure, interruptions are not failures
+    int enter(uint32_t min_complete, uint32_t flags)
+    {
+        uint32_t submit = pending();
+        long result = syscall(__NR_io_uring_enter, m_fd, submit, min_complete,
+                              flags, nullptr, 0);
+        if (result < 0)
+        {
+            return errno == EINTR ? 0 : -errno;
+        }
+
+        m_submitted += (uint32_t)result;
+        return 0;
+    }
+
+    /// Unmap the queue and close its file descriptor
+    void release()
+    {
+        if (m_sqes != nullptr)
+        {
+            munmap(m_sqes, m_sqes_size);
+            m_sqes = nullptr;
+        }
+        if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring)
+        {
+            munmap(m_cq_ring, m_cq_ring_size);
+        }
+        m_cq_ring = nullptr;
+        if (m_sq_ring != nullptr)
+        {
+            munmap(m_sq_ring, m_sq_ring_size);
+            m_sq_ring = nullptr;
+        }
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+private:
+    /// The mapped rings
+    uint8_t* m_sq_ring = nullptr;
+    uint8_t* m_cq_ring = nullptr;
+    io_uring_sqe* m_sqes = nullptr;
+    std::size_t m_sq_ring_size = 0;
+    std::size_t m_cq_ring_size = 0;
+    std::size_t m_sqes_size = 0;
+
+    /// The submission queue
+    uint32_t* m_sq_head = nullptr;
+    uint32_t* m_sq_tail = nullptr;
+    uint32_t* m_sq_array = nullptr;
+    uint32_t m_sq_mask = 0;
+    uint32_t m_sq_entries = 0;
+
+    /// The submission queue tail the kernel has been told about
+    uint32_t m_submitted = 0;
+
+    /// The completion queue
+    uint32_t* m_cq_head = nullptr;
+    uint32_t* m_cq_tail = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    uint32_t m_cq_mask = 0;
+#else
+    bool init(uint32_t entries)
+    {
+        (void)entries;
+        return false;
+    }
+
+private:
+    void release()
+    {
+    }
+#endif
+
+public:
+    /// @return true if the queue has been set up
+    bool is_initialized() const
+    {
+        return m_fd >= 0;
+    }
+
+private:
+    /// The io_uring file descriptor
+    int m_fd = -1;
+};
+} // namespace chunkie
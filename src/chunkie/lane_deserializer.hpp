@@ -0,0 +1,124 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "deserializer.hpp"
+
+namespace chunkie
+{
+/// Deserializer for the buffers written by a priority_serializer.
+///
+/// Every lane has its own deserializer, so an object interrupted by objects
+/// of other lanes is continued when the next buffer of its lane arrives.
+/// The object passed to write_to_object() must therefore be kept per lane
+/// until it is completed. Buffers with an unknown lane id are ignored.
+template <typename HeaderType = uint32_t>
+class lane_deserializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The deserializer of each lane
+    using deserializer_type = deserializer<header_type>;
+
+    /// The size of the lane id at the start of each buffer
+    static const header_type lane_size = 1;
+
+public:
+    /// @param lanes the number of lanes
+    explicit lane_deserializer(uint32_t lanes) : m_lanes(lanes)
+    {
+        assert(lanes > 0 && lanes <= 256 && "Invalid number of lanes");
+    }
+
+    /// Read from a buffer, the buffers of each lane must be read in-order
+    void set_buffer(const uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(buffer_proccessed() && "Previous buffer not proccessed");
+
+        m_object_completed = false;
+
+        if (size <= lane_size + deserializer_type::header_size ||
+            data[0] >= m_lanes.size())
+        {
+            return;
+        }
+
+        m_lane = data[0];
+        m_lanes[m_lane].set_buffer(data + lane_size, size - lane_size);
+
+        if (m_lanes[m_lane].buffer_proccessed())
+        {
+            m_lane = none;
+        }
+    }
+
+    /// @returns true if all data in the set buffer have been processed
+    bool buffer_proccessed() const
+    {
+        return m_lane == none;
+    }
+
+    /// @return the lane of the current buffer
+    uint32_t lane() const
+    {
+        assert(!buffer_proccessed() && "No buffer set");
+        return m_lane;
+    }
+
+    /// @returns the size of the current object being parsed
+    header_type object_size() const
+    {
+        assert(!buffer_proccessed() && "No buffer set");
+        return m_lanes[m_lane].object_size();
+    }
+
+    /// Writes available bytes to the given pointer, which must be the same
+    /// for all parts of an object of the lane.
+    void write_to_object(uint8_t* object)
+    {
+        assert(!buffer_proccessed() && "No buffer set");
+
+        auto& d = m_lanes[m_lane];
+        d.write_to_object(object);
+        m_object_completed = d.object_completed();
+
+        if (d.buffer_proccessed())
+        {
+            m_lane = none;
+        }
+    }
+
+    /// @return true if the final part of an object was written
+    bool object_completed() const
+    {
+        return m_object_completed;
+    }
+
+private:
+    /// No current lane
+    static const uint32_t none = 0xFFFFFFFFU;
+
+private:
+    /// The deserializer of each lane
+    std::vector<deserializer_type> m_lanes;
+
+    /// The lane of the current buffer
+    uint32_t m_lane = none;
+
+    /// Bool for determining completion
+    bool m_object_completed = false;
+};
+
+template <class T>
+const T lane_deserializer<T>::lane_size;
+} // namespace chunkie
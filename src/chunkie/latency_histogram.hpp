@@ -0,0 +1,179 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace chunkie
+{
+/// Lock-free histogram of latencies in nanoseconds.
+///
+/// The buckets are log-linear, as in an HDR histogram: values below
+/// sub_bucket_count are counted exactly, and every power of two above is
+/// split into sub_bucket_count / 2 equally sized buckets. The relative
+/// error of a reported value is therefore at most 2 / sub_bucket_count,
+/// about 3%, over the full 64 bit range.
+///
+/// Values can be recorded by one thread while others read the percentiles.
+/// Every counter is updated with a single relaxed atomic increment, so
+/// percentiles read during recording may lag slightly behind.
+class latency_histogram
+{
+public:
+    /// The number of bits of precision of each bucket
+    static const uint32_t precision = 5;
+
+    /// The number of exactly counted values
+    static const uint64_t sub_bucket_count = 1ULL << precision;
+
+    /// The total number of buckets
+    static const uint32_t bucket_count =
+        sub_bucket_count + (64 - precision) * (sub_bucket_count / 2);
+
+public:
+    latency_histogram()
+    {
+        reset();
+    }
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    /// Record a value
+    void record(uint64_t value)
+    {
+        m_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(
+                                  max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// @return the number of recorded values
+    uint64_t count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /// @return the largest recorded value
+    uint64_t max() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    /// @param percentile the percentile between 0 and 100
+    /// @return the value below or at which the given percentage of the
+    ///         recorded values are, or 0 if nothing is recorded
+    uint64_t percentile(double percentile) const
+    {
+        assert(percentile >= 0.0 && percentile <= 100.0);
+
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < bucket_count; ++i)
+        {
+            total += m_buckets[i].load(std::memory_order_relaxed);
+        }
+
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        auto target = (uint64_t)(percentile / 100.0 * total + 0.5);
+        target = target == 0 ? 1 : target;
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < bucket_count; ++i)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target)
+            {
+                return highest_value(i);
+            }
+        }
+
+        return highest_value(bucket_count - 1);
+    }
+
+    /// Clear the histogram. Values recorded concurrently may be lost.
+    void reset()
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    /// @return the index of the bucket counting the value
+    static uint32_t bucket_index(uint64_t value)
+    {
+        if (value < sub_bucket_count)
+        {
+            return (uint32_t)value;
+        }
+
+        uint32_t shift = most_significant_bit(value) - precision + 1;
+        uint64_t sub_bucket = (value >> shift) - sub_bucket_count / 2;
+
+        return (uint32_t)(sub_bucket_count +
+                          (shift - 1) * (sub_bucket_count / 2) + sub_bucket);
+    }
+
+    /// @return the highest value counted by a bucket
+    static uint64_t highest_value(uint32_t index)
+    {
+        assert(index < bucket_count);
+
+        if (index < sub_bucket_count)
+        {
+            return index;
+        }
+
+        uint32_t shift = (uint32_t)((index - sub_bucket_count) /
+                                    (sub_bucket_count / 2)) +
+                         1;
+        uint64_t sub_bucket =
+            (index - sub_bucket_count) % (sub_bucket_count / 2) +
+            sub_bucket_count / 2;
+
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+private:
+    /// @return the position of the most significant set bit of the value
+    static uint32_t most_significant_bit(uint64_t value)
+    {
+        assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - (uint32_t)__builtin_clzll(value);
+#else
+        uint32_t bit = 0;
+        while (value >>= 1)
+        {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+private:
+    /// The buckets
+    std::atomic<uint64_t> m_buckets[bucket_count];
+
+    /// The number of recorded values
+    std::atomic<uint64_t> m_count;
+
+    /// The largest recorded value
+    std::atomic<uint64_t> m_max;
+};
+} // namespace chunkie
@@ -0,0 +1,114 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+
+namespace chunkie
+{
+/// Unbounded intrusive lock-free queue with many producer threads and a
+/// single consumer thread.
+///
+/// The queue links the pushed nodes through their m_next member, an
+/// std::atomic<NodeType*>, so pushing never allocates. Pushing is a single
+/// atomic exchange, which keeps the cost for producers constant no matter
+/// how many threads push at the same time. The algorithm is the one by
+/// Dmitry Vyukov: a pop may find the queue momentarily empty while a push
+/// is in progress, in which case it returns nullptr and the node is
+/// returned by a later pop.
+template <typename NodeType>
+class mpsc_queue
+{
+public:
+    /// Type def
+    using node_type = NodeType;
+
+public:
+    mpsc_queue() : m_head(&m_stub), m_tail(&m_stub)
+    {
+        m_stub.m_next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /// Push a node. May be called by any thread. The node must stay alive
+    /// until it has been popped.
+    void push(node_type* node)
+    {
+        assert(node != nullptr && "Null pointer provided");
+
+        node->m_next.store(nullptr, std::memory_order_relaxed);
+        node_type* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->m_next.store(node, std::memory_order_release);
+    }
+
+    /// Pop a node. Must only be called by the consumer.
+    /// @return the oldest node, or nullptr if the queue is empty or the
+    ///         oldest node is still being pushed
+    node_type* pop()
+    {
+        node_type* tail = m_tail;
+        node_type* next = tail->m_next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+
+            m_tail = next;
+            tail = next;
+            next = next->m_next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        if (tail != m_head.load(std::memory_order_acquire))
+        {
+            // A producer is linking in the next node
+            return nullptr;
+        }
+
+        // The tail is the last node, the stub is pushed behind it so it can
+        // be handed out
+        push(&m_stub);
+
+        next = tail->m_next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    /// @return true if the queue is empty, only exact when called by the
+    ///         consumer with no push in progress
+    bool empty() const
+    {
+        return m_tail == &m_stub &&
+               m_stub.m_next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    /// The node kept in the queue when it is empty
+    node_type m_stub;
+
+    /// The most recently pushed node, written by the producers
+    std::atomic<node_type*> m_head;
+
+    /// The oldest node, owned by the consumer
+    node_type* m_tail;
+};
+} // namespace chunkie
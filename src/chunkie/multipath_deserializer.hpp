@@ -0,0 +1,253 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "deserializer.hpp"
+
+namespace chunkie
+{
+/// Deserializer for a stream of buffers sent redundantly over several paths,
+/// where every buffer carries an identifier given by the transport, counting
+/// up by one per buffer.
+///
+/// The first copy of a buffer to arrive from any path is used and later
+/// copies are dropped. A sliding bitmap covers the window of identifiers
+/// following the next buffer to be read, so detecting a duplicate is a
+/// single bit test, and anything older than the window has already been
+/// read or given up on. Buffers arriving in order are deserialized directly
+/// from the caller's memory. A buffer arriving ahead of a missing one is
+/// copied into the window once, and deserialized as soon as the missing
+/// buffer arrives from any path. Each buffer is therefore deserialized once,
+/// and objects complete as soon as the fastest path allows.
+///
+/// A missing buffer is given up on when a buffer arrives beyond the window,
+/// or when flush() is called, e.g. after a timeout. The objects it belonged
+/// to are then dropped, as with a lost buffer in the deserializer.
+template <typename HeaderType = uint32_t>
+class multipath_deserializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The deserializer reassembling the objects
+    using deserializer_type = deserializer<header_type>;
+
+public:
+    /// @param window the number of buffers which can arrive ahead of a
+    ///        missing buffer, a power of two and at least 64
+    /// @param max_buffer_size the maximum size of a buffer
+    /// @param first_sequence the identifier of the first buffer
+    multipath_deserializer(std::size_t window, std::size_t max_buffer_size,
+                           uint64_t first_sequence = 0) :
+        m_window(window), m_max_buffer_size(max_buffer_size),
+        m_bitmap(window / 64, 0), m_sizes(window, 0),
+        m_slots(window * max_buffer_size), m_next(first_sequence)
+    {
+        assert(window >= 64 && "Window too small");
+        assert((window & (window - 1)) == 0 && "Window must be a power of two");
+        assert(max_buffer_size > 0 && "Buffers must have a size");
+    }
+
+    /// Read a buffer received from any path
+    /// @param sequence the identifier of the buffer
+    /// @param data the buffer
+    /// @param size the size of the buffer
+    /// @return false if the buffer was dropped as a duplicate or as older
+    ///         than the window
+    bool read_buffer(uint64_t sequence, const uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(size <= m_max_buffer_size && "Buffer too large");
+
+        if (sequence < m_next || is_held(sequence))
+        {
+            m_duplicates++;
+            return false;
+        }
+
+        // Give up on missing buffers until the buffer fits in the window
+        while (sequence - m_next >= m_window)
+        {
+            if (m_held == 0)
+            {
+                // Without held buffers the window can move in one step
+                auto next = sequence - m_window + 1;
+                m_lost += next - m_next;
+                m_next = next;
+                break;
+            }
+
+            skip();
+        }
+
+        if (sequence == m_next)
+        {
+            deserialize(data, size);
+            m_next++;
+            drain();
+            return true;
+        }
+
+        auto index = sequence & (m_window - 1);
+        std::memcpy(m_slots.data() + index * m_max_buffer_size, data, size);
+        m_sizes[index] = size;
+        m_bitmap[index / 64] |= uint64_t(1) << (index % 64);
+        m_held++;
+        return true;
+    }
+
+    /// Give up on all missing buffers and deserialize the held buffers
+    void flush()
+    {
+        while (m_held > 0)
+        {
+            skip();
+        }
+    }
+
+    /// @return the number of completed objects waiting to be taken
+    std::size_t completed_objects() const
+    {
+        return m_completed.size();
+    }
+
+    /// Take the oldest completed object
+    /// @param object set to the data of the object
+    void take_object(std::vector<uint8_t>& object)
+    {
+        assert(!m_completed.empty() && "No completed object");
+
+        object = std::move(m_completed.front());
+        m_completed.pop_front();
+    }
+
+    /// @return the identifier of the next buffer to be deserialized
+    uint64_t next_sequence() const
+    {
+        return m_next;
+    }
+
+    /// @return the number of buffers dropped as duplicates or as too old
+    uint64_t duplicates() const
+    {
+        return m_duplicates;
+    }
+
+    /// @return the number of buffers given up on
+    uint64_t lost_buffers() const
+    {
+        return m_lost;
+    }
+
+private:
+    /// @return true if the buffer is held in the window
+    bool is_held(uint64_t sequence) const
+    {
+        if (sequence - m_next >= m_window)
+        {
+            return false;
+        }
+
+        auto index = sequence & (m_window - 1);
+        return (m_bitmap[index / 64] >> (index % 64)) & 1;
+    }
+
+    /// Deserialize the next buffer if held, or give up on it
+    void skip()
+    {
+        if (!is_held(m_next))
+        {
+            m_next++;
+            m_lost++;
+            return;
+        }
+
+        drain();
+    }
+
+    /// Deserialize the held buffers following in sequence
+    void drain()
+    {
+        while (is_held(m_next))
+        {
+            auto index = m_next & (m_window - 1);
+            m_bitmap[index / 64] &= ~(uint64_t(1) << (index % 64));
+            m_held--;
+
+            deserialize(m_slots.data() + index * m_max_buffer_size,
+                        m_sizes[index]);
+            m_next++;
+        }
+    }
+
+    /// Deserialize a buffer, collecting the completed objects
+    void deserialize(const uint8_t* data, header_type size)
+    {
+        if (size <= deserializer_type::header_size)
+        {
+            return;
+        }
+
+        m_deserializer.set_buffer(data, size);
+        while (!m_deserializer.buffer_proccessed())
+        {
+            m_object.resize(m_deserializer.object_size());
+            m_deserializer.write_to_object(m_object.data());
+
+            if (m_deserializer.object_completed())
+            {
+                m_completed.push_back(std::move(m_object));
+                m_object.clear();
+            }
+        }
+    }
+
+private:
+    /// The number of identifiers covered by the window
+    std::size_t m_window;
+
+    /// The size of every slot
+    std::size_t m_max_buffer_size;
+
+    /// One bit per identifier in the window, set if the buffer is held
+    std::vector<uint64_t> m_bitmap;
+
+    /// The sizes of the held buffers
+    std::vector<header_type> m_sizes;
+
+    /// The held buffers
+    std::vector<uint8_t> m_slots;
+
+    /// The number of held buffers
+    std::size_t m_held = 0;
+
+    /// The identifier of the next buffer to be deserialized
+    uint64_t m_next;
+
+    /// The deserializer
+    deserializer_type m_deserializer;
+
+    /// The object being reassembled
+    std::vector<uint8_t> m_object;
+
+    /// Completed objects waiting to be taken
+    std::deque<std::vector<uint8_t>> m_completed;
+
+    /// The number of buffers dropped as duplicates or as too old
+    uint64_t m_duplicates = 0;
+
+    /// The number of buffers given up on
+    uint64_t m_lost = 0;
+};
+} // namespace chunkie
@@ -0,0 +1,40 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+namespace chunkie
+{
+/// A range of bytes missing from an object, or a range of objects missing
+/// entirely, reported by the repair_deserializer and regenerated by the
+/// repair_serializer.
+template <typename HeaderType = uint32_t>
+struct nack
+{
+    /// The sequence number of the object
+    uint32_t m_sequence;
+
+    /// The offset of the first missing byte
+    HeaderType m_offset;
+
+    /// The number of missing bytes, 0 if the whole object is missing and
+    /// its size is unknown
+    HeaderType m_length;
+
+    /// The number of consecutive objects missing entirely from the
+    /// sequence number on, 1 unless the length is 0
+    uint32_t m_count = 1;
+};
+
+/// @return true if the nacks are equal
+template <typename HeaderType>
+bool operator==(const nack<HeaderType>& a, const nack<HeaderType>& b)
+{
+    return a.m_sequence == b.m_sequence && a.m_offset == b.m_offset &&
+           a.m_length == b.m_length && a.m_count == b.m_count;
+}
+} // namespace chunkie
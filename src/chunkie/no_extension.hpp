@@ -0,0 +1,51 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+namespace chunkie
+{
+/// The default start header extension of the serializer and deserializer,
+/// which adds nothing to the wire format.
+///
+/// A start header extension adds size bytes directly after the header of
+/// every fragment that starts an object. The serializer calls write() with a
+/// pointer to these bytes, and the deserializer calls read() when parsing
+/// them. The extension is available through the extension() member of both
+/// and describes the current object.
+///
+/// In addition the serializer calls on_set_object() when an object is set,
+/// and the deserializer calls on_object_completed() when the last part of
+/// an object has been written.
+struct no_extension
+{
+    /// The number of bytes added after a start header
+    static const std::size_t size = 0;
+
+    /// Write the extension
+    void write(uint8_t* data) const
+    {
+        (void)data;
+    }
+
+    /// Read the extension
+    void read(const uint8_t* data)
+    {
+        (void)data;
+    }
+
+    /// Called by the serializer when an object is set
+    void on_set_object()
+    {
+    }
+
+    /// Called by the deserializer when an object is completed
+    void on_object_completed()
+    {
+    }
+};
+} // namespace chunkie
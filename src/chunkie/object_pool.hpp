@@ -0,0 +1,248 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace chunkie
+{
+class object_pool;
+
+/// Reference counted, immutable handle to an object allocated from an
+/// object_pool. Copying the handle only increments a counter, the storage is
+/// returned to the pool when the last handle is destroyed.
+class shared_object
+{
+private:
+    friend class object_pool;
+
+    struct pool_state;
+
+    /// The pooled storage, shared by all handles to the same object
+    struct node
+    {
+        std::atomic<uint32_t> m_references{0};
+        std::vector<uint8_t> m_data;
+        pool_state* m_pool = nullptr;
+    };
+
+    /// The state shared between a pool and its outstanding objects
+    struct pool_state
+    {
+        std::mutex m_mutex;
+        std::vector<node*> m_free;
+        std::size_t m_outstanding = 0;
+        bool m_pool_alive = true;
+    };
+
+    explicit shared_object(node* object) : m_node(object)
+    {
+        assert(m_node != nullptr);
+        m_node->m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    /// Create an empty handle
+    shared_object() = default;
+
+    shared_object(const shared_object& other) : m_node(other.m_node)
+    {
+        if (m_node != nullptr)
+        {
+            m_node->m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    shared_object(shared_object&& other) noexcept : m_node(other.m_node)
+    {
+        other.m_node = nullptr;
+    }
+
+    shared_object& operator=(shared_object other) noexcept
+    {
+        std::swap(m_node, other.m_node);
+        return *this;
+    }
+
+    ~shared_object()
+    {
+        reset();
+    }
+
+    /// Drop this reference to the object
+    void reset()
+    {
+        if (m_node == nullptr)
+        {
+            return;
+        }
+
+        node* object = m_node;
+        m_node = nullptr;
+
+        if (object->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            release(object);
+        }
+    }
+
+    /// @return pointer to the object data
+    const uint8_t* data() const
+    {
+        assert(m_node != nullptr && "Empty handle");
+        return m_node->m_data.data();
+    }
+
+    /// @return the size of the object in bytes
+    std::size_t size() const
+    {
+        assert(m_node != nullptr && "Empty handle");
+        return m_node->m_data.size();
+    }
+
+    /// @return the number of handles referencing the object
+    uint32_t use_count() const
+    {
+        if (m_node == nullptr)
+        {
+            return 0;
+        }
+        return m_node->m_references.load(std::memory_order_relaxed);
+    }
+
+    /// @return true if the handle references an object
+    explicit operator bool() const
+    {
+        return m_node != nullptr;
+    }
+
+private:
+    /// Return the storage of an unreferenced object to its pool
+    static void release(node* object)
+    {
+        pool_state* pool = object->m_pool;
+        bool destroy_pool = false;
+
+        {
+            std::lock_guard<std::mutex> lock(pool->m_mutex);
+            if (pool->m_pool_alive)
+            {
+                pool->m_free.push_back(object);
+                object = nullptr;
+            }
+
+            pool->m_outstanding--;
+            destroy_pool = !pool->m_pool_alive && pool->m_outstanding == 0;
+        }
+
+        delete object;
+
+        if (destroy_pool)
+        {
+            delete pool;
+        }
+    }
+
+private:
+    /// The referenced object
+    node* m_node = nullptr;
+};
+
+/// Pool of recycled object storage handed out as shared_object handles.
+///
+/// Objects can be released from any thread. The pool may be destroyed while
+/// handles are still alive, the remaining storage is then freed when the last
+/// handle is dropped.
+class object_pool
+{
+private:
+    using node = shared_object::node;
+    using pool_state = shared_object::pool_state;
+
+public:
+    object_pool() : m_state(new pool_state())
+    {
+    }
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    ~object_pool()
+    {
+        bool destroy_pool = false;
+        std::vector<node*> free;
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->m_mutex);
+            m_state->m_pool_alive = false;
+            free.swap(m_state->m_free);
+            destroy_pool = m_state->m_outstanding == 0;
+        }
+
+        for (auto object : free)
+        {
+            delete object;
+        }
+
+        if (destroy_pool)
+        {
+            delete m_state;
+        }
+    }
+
+    /// @param size the size of the object
+    /// @return a handle to an object of the given size, the storage is reused
+    /// from a previously released object when one is available
+    shared_object acquire(std::size_t size)
+    {
+        node* object = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->m_mutex);
+            if (!m_state->m_free.empty())
+            {
+                object = m_state->m_free.back();
+                m_state->m_free.pop_back();
+            }
+            m_state->m_outstanding++;
+        }
+
+        if (object == nullptr)
+        {
+            object = new node();
+            object->m_pool = m_state;
+        }
+
+        object->m_data.resize(size);
+        return shared_object(object);
+    }
+
+    /// @return writable pointer to the data of an object that has not yet
+    /// been shared, i.e. only a single handle references it
+    static uint8_t* mutable_data(shared_object& object)
+    {
+        assert(object && "Empty handle");
+        assert(object.use_count() == 1 && "Object is shared");
+        return object.m_node->m_data.data();
+    }
+
+    /// @return the number of released objects ready for reuse
+    std::size_t free_objects() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        return m_state->m_free.size();
+    }
+
+private:
+    /// The state shared with the outstanding objects
+    pool_state* m_state;
+};
+} // namespace chunkie
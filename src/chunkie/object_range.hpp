@@ -0,0 +1,237 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "object_view.hpp"
+
+namespace chunkie
+{
+/// Lazy range of the objects completed by a deserializer reading a range of
+/// buffers.
+///
+/// The buffers are read from an input iterator range one at a time, and an
+/// iterator only moves on to the next buffer once the deserializer has
+/// processed the current one. The buffers may therefore be produced lazily
+/// as well, e.g. by a buffer_range. Every object is reassembled in the same
+/// storage, so an object is only valid until the iterator is incremented.
+///
+/// The buffers must provide data() and size(), or be object_view.
+///
+///     std::vector<uint8_t> object;
+///     for (auto view : chunkie::make_object_range(
+///              deserializer, buffers.begin(), buffers.end(), object))
+///     {
+///         consume(view.m_data, view.m_size);
+///     }
+template <typename Deserializer, typename BufferIterator>
+class object_range
+{
+public:
+    /// The deserializer reassembling the objects
+    using deserializer_type = Deserializer;
+
+    /// typedef
+    using header_type = typename deserializer_type::header_type;
+
+    /// The objects of the range
+    using value_type = object_view<header_type>;
+
+    /// Input iterator over the completed objects
+    class iterator
+    {
+    public:
+        /// Iterator traits
+        using iterator_category = std::input_iterator_tag;
+        using value_type = object_range::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+    public:
+        explicit iterator(object_range* range = nullptr) : m_range(range)
+        {
+        }
+
+        /// @return the current object
+        reference operator*() const
+        {
+            assert(!done() && "Dereferencing the end of the range");
+            return m_range->m_object;
+        }
+
+        /// @return the current object
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        /// Reassemble the next object
+        iterator& operator++()
+        {
+            assert(!done() && "Incrementing the end of the range");
+            m_range->advance();
+            return *this;
+        }
+
+        /// Reassemble the next object
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return done() == other.done();
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        /// @return true if all buffers have been read
+        bool done() const
+        {
+            return m_range == nullptr || m_range->m_object.m_size == 0;
+        }
+
+    private:
+        /// The range
+        object_range* m_range;
+    };
+
+public:
+    /// @param deserializer the deserializer, with no buffer set
+    /// @param first the first buffer
+    /// @param last the end of the buffers
+    /// @param object the storage the objects are reassembled in
+    object_range(deserializer_type& deserializer, BufferIterator first,
+                 BufferIterator last, std::vector<uint8_t>& object) :
+        m_deserializer(deserializer),
+        m_first(first), m_last(last), m_storage(object)
+    {
+        assert(m_deserializer.buffer_proccessed() &&
+               "Previous buffer not proccessed");
+    }
+
+    /// Reassemble the first object
+    /// @return the iterator at the first object, may only be called once
+    iterator begin()
+    {
+        advance();
+        return iterator(this);
+    }
+
+    /// @return the end iterator
+    iterator end()
+    {
+        return iterator();
+    }
+
+private:
+    /// Read buffers until an object is completed, or mark the range done if
+    /// there are no more buffers
+    void advance()
+    {
+        while (true)
+        {
+            if (m_deserializer.buffer_proccessed())
+            {
+                if (m_buffer_set)
+                {
+                    ++m_first;
+                    m_buffer_set = false;
+                }
+
+                if (m_first == m_last)
+                {
+                    m_object = {nullptr, 0};
+                    return;
+                }
+
+                const auto& buffer = *m_first;
+                m_deserializer.set_buffer(buffer_data(buffer),
+                                          (header_type)buffer_size(buffer));
+                m_buffer_set = true;
+                continue;
+            }
+
+            m_storage.resize(m_deserializer.object_size());
+            m_deserializer.write_to_object(m_storage.data());
+
+            if (m_deserializer.object_completed())
+            {
+                m_object = {m_storage.data(), (header_type)m_storage.size()};
+                return;
+            }
+        }
+    }
+
+    /// @return the data of a buffer
+    template <typename Buffer>
+    static const uint8_t* buffer_data(const Buffer& buffer)
+    {
+        return buffer.data();
+    }
+
+    /// @return the data of a buffer
+    template <typename T>
+    static const uint8_t* buffer_data(const object_view<T>& buffer)
+    {
+        return buffer.m_data;
+    }
+
+    /// @return the size of a buffer
+    template <typename Buffer>
+    static std::size_t buffer_size(const Buffer& buffer)
+    {
+        return buffer.size();
+    }
+
+    /// @return the size of a buffer
+    template <typename T>
+    static std::size_t buffer_size(const object_view<T>& buffer)
+    {
+        return buffer.m_size;
+    }
+
+private:
+    /// The deserializer
+    deserializer_type& m_deserializer;
+
+    /// The current buffer
+    BufferIterator m_first;
+
+    /// The end of the buffers
+    BufferIterator m_last;
+
+    /// True if the current buffer has been set in the deserializer
+    bool m_buffer_set = false;
+
+    /// The storage of the objects
+    std::vector<uint8_t>& m_storage;
+
+    /// The current object, empty when the range is done
+    value_type m_object{nullptr, 0};
+};
+
+/// @return an object_range over the buffers from first to last
+template <typename Deserializer, typename BufferIterator>
+object_range<Deserializer, BufferIterator>
+make_object_range(Deserializer& deserializer, BufferIterator first,
+                  BufferIterator last, std::vector<uint8_t>& object)
+{
+    return object_range<Deserializer, BufferIterator>(deserializer, first,
+                                                      last, object);
+}
+} // namespace chunkie
@@ -0,0 +1,22 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+namespace chunkie
+{
+/// A non-owning view of an object
+template <typename HeaderType = uint8_t>
+struct object_view
+{
+    /// The data of the object
+    const uint8_t* m_data;
+
+    /// The size of the object
+    HeaderType m_size;
+};
+} // namespace chunkie
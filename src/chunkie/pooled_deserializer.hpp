@@ -0,0 +1,91 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <utility>
+
+#include "deserializer.hpp"
+#include "object_pool.hpp"
+
+namespace chunkie
+{
+/// Deserializer which reassembles objects directly into storage from an
+/// object_pool. Completed objects are handed out as shared_object handles
+/// that can be passed to several consumers without copying the data.
+template <typename HeaderType = uint32_t>
+class pooled_deserializer
+{
+public:
+    /// Type def
+    using header_type = HeaderType;
+
+public:
+    /// @param pool the pool from which objects are allocated, must outlive
+    ///        the deserializer
+    explicit pooled_deserializer(object_pool& pool) : m_pool(pool)
+    {
+    }
+
+    /// Read from a buffer. buffers must be read in-order,
+    void set_buffer(const uint8_t* data, header_type size)
+    {
+        m_deserializer.set_buffer(data, size);
+    }
+
+    /// @returns true if all data in the set buffer have been processed
+    bool buffer_proccessed() const
+    {
+        return m_deserializer.buffer_proccessed();
+    }
+
+    /// @returns the size of the current object being parsed
+    header_type object_size() const
+    {
+        return m_deserializer.object_size();
+    }
+
+    /// Writes available bytes to the current object. A new object is
+    /// acquired from the pool when a new object starts.
+    void write_to_object()
+    {
+        auto size = m_deserializer.object_size();
+
+        // Partially written objects of a matching size are overwritten from
+        // the start when the next object begins, so the storage can be kept.
+        if (!m_object || m_object.size() != size)
+        {
+            m_object = m_pool.acquire(size);
+        }
+
+        m_deserializer.write_to_object(object_pool::mutable_data(m_object));
+    }
+
+    /// @return true if the final part of an object was written
+    bool object_completed() const
+    {
+        return m_deserializer.object_completed();
+    }
+
+    /// @return the completed object, the deserializer gives up its reference
+    shared_object release_object()
+    {
+        assert(object_completed() && "No completed object");
+        assert(m_object && "Object already released");
+        return std::move(m_object);
+    }
+
+private:
+    /// The pool objects are allocated from
+    object_pool& m_pool;
+
+    /// The deserializer parsing the buffers
+    deserializer<header_type> m_deserializer;
+
+    /// The object currently being reassembled
+    shared_object m_object;
+};
+} // namespace chunkie
@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace chunkie
+{
+/// Copy policy prefetching the source ahead of the copy.
+///
+/// The copy is made in blocks while the source data a fixed distance ahead
+/// is requested from memory, hiding the memory latency of sources which are
+/// not in the cache, such as objects received by the network card or
+/// written by another core. The prefetches are hinted as non-temporal, to
+/// keep the source from displacing other data in the cache.
+struct prefetch_copy
+{
+    /// The size of each block copied
+    static const std::size_t block_size = 256;
+
+    /// The distance in bytes prefetched ahead of the copy
+    static const std::size_t prefetch_distance = 1024;
+
+    /// Copy size bytes from source to destination
+    static void copy(uint8_t* destination, const uint8_t* source,
+                     std::size_t size, std::size_t object_size)
+    {
+        (void)object_size;
+
+        std::size_t offset = 0;
+        for (; offset + block_size <= size; offset += block_size)
+        {
+            if (offset + prefetch_distance < size)
+            {
+                for (std::size_t line = 0; line < block_size; line += 64)
+                {
+                    prefetch(source + offset + prefetch_distance + line);
+                }
+            }
+
+            std::memcpy(destination + offset, source + offset, block_size);
+        }
+
+        std::memcpy(destination + offset, source + offset, size - offset);
+    }
+
+private:
+    /// Prefetch the cache line holding data
+    static void prefetch(const uint8_t* data)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(data, 0, 0);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(reinterpret_cast<const char*>(data), _MM_HINT_NTA);
+#else
+        (void)data;
+#endif
+    }
+};
+} // namespace chunkie
@@ -0,0 +1,183 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "serializer.hpp"
+
+namespace chunkie
+{
+/// Serializer interleaving objects of different priority.
+///
+/// Objects are queued in lanes, lane 0 having the highest priority. Every
+/// buffer is filled from the highest priority lane with queued objects, so
+/// an urgent object is written to the next buffer no matter how much of a
+/// large object in a lower priority lane remains. The large object is
+/// continued where it was left once the higher lanes are empty.
+///
+/// Each buffer starts with a byte holding the lane id, followed by
+/// fragments of objects from that lane in the serializer format. The
+/// lane_deserializer reassembles the objects of every lane independently.
+///
+/// Objects are not copied and must be kept until written. The objects of a
+/// lane are written in the order they were queued, and
+/// completed_objects() tells how many of them have been written.
+template <typename HeaderType = uint32_t>
+class priority_serializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The serializer of each lane
+    using serializer_type = serializer<header_type>;
+
+    /// The size of the lane id at the start of each buffer
+    static const header_type lane_size = 1;
+
+    /// The maximum number of lanes
+    static const uint32_t max_lanes = 256;
+
+public:
+    /// @param lanes the number of lanes
+    explicit priority_serializer(uint32_t lanes) : m_lanes(lanes)
+    {
+        assert(lanes > 0 && lanes <= max_lanes && "Invalid number of lanes");
+    }
+
+    /// @return the number of lanes
+    uint32_t lanes() const
+    {
+        return (uint32_t)m_lanes.size();
+    }
+
+    /// Queue an object
+    /// @param lane the lane of the object, lower lanes are written first
+    /// @param object the object, must be kept until it has been written
+    /// @param size the size of the object
+    void push_object(uint32_t lane, const uint8_t* object, header_type size)
+    {
+        assert(lane < m_lanes.size() && "Invalid lane");
+        assert(object != nullptr && "Null pointer provided");
+        assert(size > 0 && "Object is empty");
+        assert(size <= serializer_type::max_object_size &&
+               "object too big for header type");
+
+        m_lanes[lane].m_queue.push_back(pending_object{object, size});
+    }
+
+    /// @return true if any lane has data left to write
+    bool has_objects() const
+    {
+        for (const auto& l : m_lanes)
+        {
+            if (!l.m_serializer.object_proccessed() || !l.m_queue.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @return the number of objects of a lane waiting to be started
+    std::size_t queued_objects(uint32_t lane) const
+    {
+        assert(lane < m_lanes.size() && "Invalid lane");
+        return m_lanes[lane].m_queue.size();
+    }
+
+    /// @return the number of objects of a lane completely written
+    uint64_t completed_objects(uint32_t lane) const
+    {
+        assert(lane < m_lanes.size() && "Invalid lane");
+        return m_lanes[lane].m_completed;
+    }
+
+    /// Fill a buffer from the highest priority lane with data
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    /// @return the number of bytes written, which is less than size if the
+    ///         lane ran out of data, or 0 if no lane has data
+    header_type write_buffer(uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(size > lane_size + serializer_type::header_size &&
+               "Buffer too small for header");
+
+        for (uint32_t index = 0; index < m_lanes.size(); ++index)
+        {
+            auto& l = m_lanes[index];
+            if (l.m_serializer.object_proccessed() && l.m_queue.empty())
+            {
+                continue;
+            }
+
+            data[0] = (uint8_t)index;
+            header_type written = lane_size;
+
+            while (size - written > serializer_type::header_size)
+            {
+                if (l.m_serializer.object_proccessed())
+                {
+                    if (l.m_queue.empty())
+                    {
+                        break;
+                    }
+
+                    auto next = l.m_queue.front();
+                    l.m_queue.pop_front();
+                    l.m_serializer.set_object(next.m_data, next.m_size);
+                }
+
+                auto bytes = std::min<header_type>(
+                    size - written, l.m_serializer.max_write_buffer_size());
+                l.m_serializer.write_buffer(data + written, bytes);
+                written += bytes;
+
+                if (l.m_serializer.object_proccessed())
+                {
+                    l.m_completed++;
+                }
+            }
+
+            return written;
+        }
+
+        return 0;
+    }
+
+private:
+    /// An object waiting to be started
+    struct pending_object
+    {
+        const uint8_t* m_data;
+        header_type m_size;
+    };
+
+    /// The state of a lane
+    struct lane
+    {
+        serializer_type m_serializer;
+        std::deque<pending_object> m_queue;
+        uint64_t m_completed = 0;
+    };
+
+private:
+    /// The lanes
+    std::vector<lane> m_lanes;
+};
+
+template <class T>
+const T priority_serializer<T>::lane_size;
+
+template <class T>
+const uint32_t priority_serializer<T>::max_lanes;
+} // namespace chunkie
@@ -0,0 +1,285 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "object_pool.hpp"
+#include "pooled_deserializer.hpp"
+#include "spsc_queue.hpp"
+
+namespace chunkie
+{
+/// Receive engine deserializing many independent streams on several worker
+/// threads.
+///
+/// Buffers are dispatched by stream key to a fixed worker, so the buffers of
+/// a stream are always deserialized in the order they were pushed. Each
+/// worker owns the deserializers of its streams and an object pool, and is
+/// fed through a lock-free single producer single consumer queue. Buffers
+/// must therefore be pushed from a single thread.
+///
+/// A worker with an empty queue yields for a while before it sleeps until a
+/// buffer is pushed, so an idle engine does not keep its cores busy. Pushing
+/// costs a memory fence to check whether the worker sleeps, and a wake up
+/// only when it does.
+template <typename HeaderType = uint32_t>
+class receive_engine
+{
+public:
+    /// Type def
+    using header_type = HeaderType;
+
+    /// Handler invoked on the worker thread for every completed object
+    using object_handler =
+        std::function<void(uint64_t stream, shared_object object)>;
+
+public:
+    /// @param threads the number of worker threads
+    /// @param queue_capacity the number of buffers that can be queued per
+    ///        worker, must be a power of two
+    /// @param handler the handler receiving completed objects, invoked
+    ///        concurrently from the worker threads
+    receive_engine(std::size_t threads, std::size_t queue_capacity,
+                   object_handler handler) :
+        m_handler(std::move(handler))
+    {
+        assert(threads > 0 && "At least one worker thread is needed");
+        assert(m_handler && "No handler provided");
+
+        for (std::size_t i = 0; i < threads; ++i)
+        {
+            m_workers.emplace_back(new worker(queue_capacity));
+        }
+
+        for (auto& w : m_workers)
+        {
+            w->m_thread = std::thread(&receive_engine::run, this, w.get());
+        }
+    }
+
+    receive_engine(const receive_engine&) = delete;
+    receive_engine& operator=(const receive_engine&) = delete;
+
+    ~receive_engine()
+    {
+        stop();
+    }
+
+    /// Queue a buffer for the given stream without blocking.
+    /// @return false if the worker queue is full, the buffer is then left
+    ///         untouched
+    bool try_push(uint64_t stream, std::vector<uint8_t>& buffer)
+    {
+        assert(!m_stopped && "Engine is stopped");
+        assert(buffer.size() > sizeof(header_type) &&
+               "Buffer smaller than header");
+
+        auto& w = *m_workers[worker_index(stream)];
+        item value{stream, std::move(buffer)};
+        if (w.m_queue.try_push(value))
+        {
+            // Pairs with the fence in run(), so either the worker sees the
+            // buffer or the buffer is pushed after the worker went to sleep
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (w.m_sleeping.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> lock(w.m_mutex);
+                w.m_wake.notify_one();
+            }
+            return true;
+        }
+
+        buffer = std::move(value.m_buffer);
+        return false;
+    }
+
+    /// Queue a buffer for the given stream, waiting while the worker queue
+    /// is full
+    void push(uint64_t stream, std::vector<uint8_t> buffer)
+    {
+        while (!try_push(stream, buffer))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Process all queued buffers and stop the worker threads
+    void stop()
+    {
+        if (m_stopped.exchange(true, std::memory_order_release))
+        {
+            return;
+        }
+
+        for (auto& w : m_workers)
+        {
+            {
+                std::lock_guard<std::mutex> lock(w->m_mutex);
+                w->m_wake.notify_one();
+            }
+            w->m_thread.join();
+        }
+    }
+
+    /// @return the number of worker threads
+    std::size_t threads() const
+    {
+        return m_workers.size();
+    }
+
+    /// @return the index of the worker processing the given stream
+    std::size_t worker_index(uint64_t stream) const
+    {
+        // Fibonacci hashing spreads consecutive stream keys over the workers
+        uint64_t hash = stream * 0x9E3779B97F4A7C15ULL;
+        return (std::size_t)((hash >> 32) % m_workers.size());
+    }
+
+private:
+    /// The number of times a worker yields on an empty queue before it
+    /// sleeps
+    static const std::size_t spin_count = 1000;
+
+    /// A buffer queued for a stream
+    struct item
+    {
+        uint64_t m_stream;
+        std::vector<uint8_t> m_buffer;
+    };
+
+    /// The state owned by a worker thread
+    struct worker
+    {
+        explicit worker(std::size_t queue_capacity) : m_queue(queue_capacity)
+        {
+        }
+
+        /// Buffers waiting to be processed
+        spsc_queue<item> m_queue;
+
+        /// The pool objects of this worker are allocated from
+        object_pool m_pool;
+
+        /// The deserializer of each stream handled by this worker
+        std::unordered_map<uint64_t, pooled_deserializer<header_type>>
+            m_deserializers;
+
+        /// The worker thread
+        std::thread m_thread;
+
+        /// Protects going to sleep against missing a wake up
+        std::mutex m_mutex;
+
+        /// Signalled when a buffer is pushed or the engine is stopped
+        std::condition_variable m_wake;
+
+        /// Set while the worker sleeps or is about to
+        std::atomic<bool> m_sleeping{false};
+    };
+
+    /// The worker thread loop
+    void run(worker* w)
+    {
+        item value;
+        std::size_t idle = 0;
+
+        while (true)
+        {
+            if (w->m_queue.try_pop(value))
+            {
+                process(w, value);
+                idle = 0;
+                continue;
+            }
+
+            // Everything pushed before stop() is visible once the flag is,
+            // so an empty queue after seeing it means all work is done.
+            if (m_stopped.load(std::memory_order_acquire))
+            {
+                if (!w->m_queue.try_pop(value))
+                {
+                    return;
+                }
+
+                process(w, value);
+                continue;
+            }
+
+            if (++idle < spin_count)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(w->m_mutex);
+            w->m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            w->m_wake.wait(lock,
+                           [this, w]
+                           {
+                               return !w->m_queue.empty() ||
+                                      m_stopped.load(std::memory_order_acquire);
+                           });
+
+            w->m_sleeping.store(false, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    /// Deserialize a buffer and hand out the completed objects
+    void process(worker* w, item& value)
+    {
+        auto it = w->m_deserializers.find(value.m_stream);
+        if (it == w->m_deserializers.end())
+        {
+            it = w->m_deserializers
+                     .emplace(std::piecewise_construct,
+                              std::forward_as_tuple(value.m_stream),
+                              std::forward_as_tuple(w->m_pool))
+                     .first;
+        }
+
+        auto& deserializer = it->second;
+        deserializer.set_buffer(value.m_buffer.data(),
+                                (header_type)value.m_buffer.size());
+
+        while (!deserializer.buffer_proccessed())
+        {
+            deserializer.write_to_object();
+            if (deserializer.object_completed())
+            {
+                m_handler(value.m_stream, deserializer.release_object());
+            }
+        }
+    }
+
+private:
+    /// The handler receiving completed objects
+    object_handler m_handler;
+
+    /// The workers
+    std::vector<std::unique_ptr<worker>> m_workers;
+
+    /// Set when the engine has been stopped
+    std::atomic<bool> m_stopped{false};
+};
+
+template <class T>
+const std::size_t receive_engine<T>::spin_count;
+} // namespace chunkie
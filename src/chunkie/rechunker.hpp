@@ -0,0 +1,275 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <endian/big_endian.hpp>
+
+#include <bitter/msb0_reader.hpp>
+#include <bitter/msb0_writer.hpp>
+
+namespace chunkie
+{
+/// Moves the fragments of a stream of serialized buffers into buffers of
+/// another size, and optionally another header type, without reassembling
+/// the objects.
+///
+/// The header of a fragment holds the number of bytes remaining of its
+/// object, so a fragment can be split or joined at any byte by writing a new
+/// header. The payload is copied once, straight from the input buffer to the
+/// output buffer, and only the position within the current object is kept.
+/// The memory and latency of a relay therefore do not depend on the object
+/// size.
+///
+/// Continuations of objects whose start was lost, and objects too large for
+/// the output header type, are dropped instead of being forwarded. If an
+/// object is cut short by a lost buffer, the output buffer ends with the
+/// truncated fragment, so that the next object starts in a new buffer.
+/// Start header extensions are not supported.
+///
+///     rechunker.set_output(output, 1200);
+///     rechunker.set_input(input, size);
+///     while (!rechunker.input_proccessed())
+///     {
+///         rechunker.write();
+///         if (rechunker.output_full())
+///         {
+///             send(output, rechunker.output_size());
+///             rechunker.set_output(output, 1200);
+///         }
+///     }
+template <typename InputHeaderType = uint32_t,
+          typename OutputHeaderType = InputHeaderType>
+class rechunker
+{
+public:
+    /// The header type of the input buffers
+    using input_header_type = InputHeaderType;
+
+    /// The header type of the output buffers
+    using output_header_type = OutputHeaderType;
+
+    /// Size of the input header
+    static const std::size_t input_header_size = sizeof(input_header_type);
+
+    /// Size of the output header
+    static const std::size_t output_header_size = sizeof(output_header_type);
+
+    /// Max size of an object in the output buffers
+    static const output_header_type max_object_size =
+        std::numeric_limits<output_header_type>::max() / 2;
+
+private:
+    /// The header consists of a start bit and a size
+    using header_reader = bitter::msb0_reader<input_header_type, 1,
+                                              (input_header_size * 8) - 1>;
+    using header_writer = bitter::msb0_writer<output_header_type, 1,
+                                              (output_header_size * 8) - 1>;
+
+public:
+    /// Read from an input buffer. buffers must be read in-order
+    /// @param data the buffer to read
+    /// @param size the size of the buffer
+    void set_input(const uint8_t* data, std::size_t size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(input_proccessed() && "Previous buffer not proccessed");
+
+        m_input = data;
+        m_input_remaining = size;
+        m_fragment_remaining = 0;
+
+        read_header();
+    }
+
+    /// @return true if all data in the input buffer has been moved
+    bool input_proccessed() const
+    {
+        return m_fragment_remaining == 0;
+    }
+
+    /// Start writing a new output buffer
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    void set_output(uint8_t* data, std::size_t size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(size > output_header_size && "Buffer too small for header");
+
+        m_output = data;
+        m_output_capacity = size;
+        m_output_size = 0;
+        m_output_continues = false;
+        m_output_closed = false;
+    }
+
+    /// @return the number of bytes written to the output buffer
+    std::size_t output_size() const
+    {
+        return m_output_size;
+    }
+
+    /// @return true if the output buffer has no room for another fragment
+    bool output_full() const
+    {
+        auto remaining = m_output_capacity - m_output_size;
+        return m_output_closed || remaining == 0 ||
+               (!m_output_continues && remaining <= output_header_size);
+    }
+
+    /// Move input data to the output buffer, until the input buffer is
+    /// processed or the output buffer is full
+    void write()
+    {
+        assert(m_output != nullptr && "No output buffer set");
+
+        while (!input_proccessed() && !output_full())
+        {
+            // The last fragment of the output buffer is extended if it is
+            // from the same object, as its header is unchanged
+            if (!m_output_continues)
+            {
+                auto header = header_writer();
+                header.template field<0>(m_object_remaining == m_object_size);
+                header.template field<1>(
+                    (output_header_type)m_object_remaining);
+                endian::big_endian::put<output_header_type>(
+                    header.data(), m_output + m_output_size);
+                m_output_size += output_header_size;
+                m_output_continues = true;
+            }
+
+            auto bytes = std::min<std::size_t>(
+                m_fragment_remaining, m_output_capacity - m_output_size);
+
+            std::memcpy(m_output + m_output_size, m_input, bytes);
+            m_output_size += bytes;
+            m_input += bytes;
+            m_input_remaining -= bytes;
+            m_fragment_remaining -= bytes;
+            m_object_remaining -= bytes;
+
+            if (m_object_remaining == 0)
+            {
+                m_output_continues = false;
+            }
+
+            if (m_fragment_remaining == 0)
+            {
+                read_header();
+            }
+        }
+    }
+
+private:
+    /// Reads headers until a fragment to forward is found or the input
+    /// buffer is processed
+    void read_header()
+    {
+        while (m_input_remaining > input_header_size)
+        {
+            auto header = header_reader(
+                endian::big_endian::get<input_header_type>(m_input));
+            auto start = header.template field<0>().template as<bool>();
+            auto remaining =
+                header.template field<1>().template as<input_header_type>();
+
+            m_input += input_header_size;
+            m_input_remaining -= input_header_size;
+
+            if (m_object_remaining != 0 &&
+                (start || remaining != m_object_remaining))
+            {
+                // The object being moved was cut short by a lost buffer. A
+                // fragment following its truncated fragment in the output
+                // buffer would be read as part of it.
+                m_object_remaining = 0;
+                m_output_closed = m_output_continues;
+            }
+
+            if (start)
+            {
+                // A new object ends the fragment of the previous one
+                m_output_continues = false;
+                m_object_size = remaining;
+                m_object_remaining = remaining;
+
+                if (remaining == 0)
+                {
+                    // Never written by a serializer
+                    break;
+                }
+
+                if (remaining > max_object_size)
+                {
+                    m_object_remaining = 0;
+                }
+            }
+
+            auto bytes = std::min<std::size_t>(m_input_remaining, remaining);
+
+            if (remaining != 0 && remaining == m_object_remaining)
+            {
+                m_fragment_remaining = bytes;
+                return;
+            }
+
+            // Skip data not belonging to a forwarded object
+            m_input += bytes;
+            m_input_remaining -= bytes;
+        }
+
+        m_input_remaining = 0;
+        m_fragment_remaining = 0;
+    }
+
+private:
+    /// The unread data of the input buffer
+    const uint8_t* m_input = nullptr;
+
+    /// The number of unread bytes in the input buffer
+    std::size_t m_input_remaining = 0;
+
+    /// The number of bytes left of the input fragment being moved
+    std::size_t m_fragment_remaining = 0;
+
+    /// The size of the object being moved
+    std::size_t m_object_size = 0;
+
+    /// The number of bytes of the object not yet moved
+    std::size_t m_object_remaining = 0;
+
+    /// The output buffer
+    uint8_t* m_output = nullptr;
+
+    /// The size of the output buffer
+    std::size_t m_output_capacity = 0;
+
+    /// The number of bytes written to the output buffer
+    std::size_t m_output_size = 0;
+
+    /// True if the output buffer ends with a fragment of the current object
+    bool m_output_continues = false;
+
+    /// True if the output buffer ends with a truncated fragment
+    bool m_output_closed = false;
+};
+
+template <class I, class O>
+const std::size_t rechunker<I, O>::input_header_size;
+
+template <class I, class O>
+const std::size_t rechunker<I, O>::output_header_size;
+
+template <class I, class O>
+const O rechunker<I, O>::max_object_size;
+} // namespace chunkie
@@ -0,0 +1,473 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <endian/big_endian.hpp>
+
+#include "nack.hpp"
+
+namespace chunkie
+{
+/// Deserializer for the fragments written by a repair_serializer, which keeps
+/// partially received objects and reports exactly which ranges are missing.
+///
+/// Fragments may arrive in any order and more than once. Objects are
+/// completed as soon as all their bytes have arrived, and handed out in the
+/// order they complete. Missing ranges are reported by nacks(), either as
+/// byte ranges of partially received objects or as whole objects of which
+/// nothing has arrived, detected from gaps in the sequence numbers.
+///
+/// Sequence numbers are compared with serial number arithmetic, so they may
+/// wrap around. Only objects within a window of sequence numbers from the
+/// newest object are kept, older objects are abandoned, and fragments further
+/// ahead than the window are dropped as corrupt. The first fragment received
+/// starts the sequence, so a receiver may join a stream at any point, and the
+/// sequence is restarted if only fragments ahead of the window keep arriving,
+/// e.g. after losing more objects than the window.
+///
+/// The memory held is bounded by the maximum object size, and by a limit on
+/// the total size of the partially received objects. The oldest partial
+/// objects are abandoned to make room for new ones.
+template <typename HeaderType = uint32_t>
+class repair_deserializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// Size of the fragment header
+    static const header_type header_size =
+        sizeof(uint32_t) + 2 * sizeof(header_type);
+
+    /// The number of consecutive fragments ahead of the window restarting
+    /// the sequence
+    static const uint32_t restart_threshold = 16;
+
+    /// The default size of the largest object accepted, 1 MiB or the
+    /// largest size the header type allows
+    static const header_type default_max_object_size =
+        std::numeric_limits<header_type>::max() / 2 < (1U << 20)
+            ? std::numeric_limits<header_type>::max() / 2
+            : (header_type)(1U << 20);
+
+    /// The default limit on the total size of the partial objects, 64 MiB
+    static const std::size_t default_max_partial_bytes = 64U << 20;
+
+public:
+    /// @param max_object_size the size of the largest object accepted,
+    ///        fragments of larger objects are dropped
+    /// @param window the number of sequence numbers kept, at most 2^30
+    /// @param max_partial_bytes the limit on the total size of the partial
+    ///        objects, at least max_object_size
+    repair_deserializer(
+        header_type max_object_size = default_max_object_size,
+        uint32_t window = 1U << 16,
+        std::size_t max_partial_bytes = default_max_partial_bytes) :
+        m_max_object_size(max_object_size), m_window(window),
+        m_max_partial_bytes(max_partial_bytes)
+    {
+        assert(max_object_size > 0 && "Objects must have a size");
+        assert(window > 0 && window <= (1U << 30) && "Invalid window");
+        assert(max_partial_bytes >= max_object_size &&
+               "Partial objects limit below the object size");
+    }
+
+    /// Read all fragments in a buffer
+    void read_buffer(const uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+
+        std::size_t offset = 0;
+
+        while (size - offset > header_size)
+        {
+            const uint8_t* header = data + offset;
+            auto sequence = endian::big_endian::get<uint32_t>(header);
+            auto object_size = endian::big_endian::get<header_type>(
+                header + sizeof(uint32_t));
+            auto object_offset = endian::big_endian::get<header_type>(
+                header + sizeof(uint32_t) + sizeof(header_type));
+
+            // Zero padding or a corrupt header ends the buffer
+            if (object_size == 0 || object_offset >= object_size)
+            {
+                return;
+            }
+
+            offset += header_size;
+
+            auto bytes = (header_type)std::min<std::size_t>(
+                size - offset, object_size - object_offset);
+
+            read_fragment(sequence, object_size, object_offset, data + offset,
+                          bytes);
+            offset += bytes;
+        }
+    }
+
+    /// @return the number of completed objects waiting to be taken
+    std::size_t completed_objects() const
+    {
+        return m_completed.size();
+    }
+
+    /// Take the oldest completed object
+    /// @param object set to the data of the object
+    /// @return the sequence number of the object
+    uint32_t take_object(std::vector<uint8_t>& object)
+    {
+        assert(!m_completed.empty() && "No completed object");
+
+        auto sequence = m_completed.front().first;
+        object = std::move(m_completed.front().second);
+        m_completed.pop_front();
+        return sequence;
+    }
+
+    /// @return the number of partially received objects
+    std::size_t partial_objects() const
+    {
+        return m_partial.size();
+    }
+
+    /// Give up on an object, it is no longer reported as missing and any
+    /// fragments of it arriving later are ignored
+    void abandon(uint32_t sequence)
+    {
+        auto it = m_partial.find(sequence);
+        if (it != m_partial.end())
+        {
+            erase_partial(it);
+        }
+        erase_missing(sequence);
+    }
+
+    /// @return the total size of the partially received objects
+    std::size_t partial_bytes() const
+    {
+        return m_partial_bytes;
+    }
+
+    /// Append the ranges currently missing to the nacks
+    ///
+    /// Objects missing entirely are reported with one nack for every gap in
+    /// the sequence numbers.
+    /// For the newest object seen only the gaps before its last received
+    /// byte are reported, as the remaining bytes may still be in flight.
+    void nacks(std::vector<nack<header_type>>& nacks) const
+    {
+        for (const auto& range : m_missing)
+        {
+            nacks.push_back(nack<header_type>{range.first, 0, 0,
+                                              range.second - range.first});
+        }
+
+        for (const auto& entry : m_partial)
+        {
+            const auto& object = entry.second;
+            bool newest = entry.first + 1 == m_next_sequence;
+
+            header_type position = 0;
+            for (const auto& range : object.m_received)
+            {
+                if (range.first > position)
+                {
+                    nacks.push_back(nack<header_type>{
+                        entry.first, position,
+                        (header_type)(range.first - position)});
+                }
+                position = range.second;
+            }
+
+            header_type size = (header_type)object.m_data.size();
+            if (!newest && position < size)
+            {
+                nacks.push_back(nack<header_type>{
+                    entry.first, position, (header_type)(size - position)});
+            }
+        }
+
+        std::sort(nacks.begin(), nacks.end(),
+                  [](const nack<header_type>& a, const nack<header_type>& b)
+                  {
+                      return serial_less()(a.m_sequence, b.m_sequence) ||
+                             (a.m_sequence == b.m_sequence &&
+                              a.m_offset < b.m_offset);
+                  });
+    }
+
+private:
+    /// Orders sequence numbers by serial number arithmetic, which is valid
+    /// as long as the numbers compared are less than 2^31 apart
+    struct serial_less
+    {
+        bool operator()(uint32_t a, uint32_t b) const
+        {
+            return (int32_t)(a - b) < 0;
+        }
+    };
+
+    /// A partially received object
+    struct partial_object
+    {
+        /// The data of the object
+        std::vector<uint8_t> m_data;
+
+        /// The received ranges as begin and end offsets, never overlapping
+        /// or adjacent
+        std::map<header_type, header_type> m_received;
+
+        /// The number of bytes received
+        header_type m_bytes = 0;
+    };
+
+    /// Place a fragment in its object
+    void read_fragment(uint32_t sequence, header_type object_size,
+                       header_type offset, const uint8_t* data,
+                       header_type size)
+    {
+        if (object_size > m_max_object_size)
+        {
+            return;
+        }
+
+        if (!m_started)
+        {
+            m_started = true;
+            m_next_sequence = sequence;
+        }
+
+        uint32_t ahead = sequence - m_next_sequence;
+        uint32_t behind = m_next_sequence - sequence;
+
+        if (ahead >= m_window && behind > m_window)
+        {
+            // Already expired, or too far ahead to be trusted unless more
+            // fragments follow it
+            if (behind < ahead || ++m_outside < restart_threshold)
+            {
+                return;
+            }
+
+            m_partial.clear();
+            m_partial_bytes = 0;
+            m_missing.clear();
+            m_next_sequence = sequence;
+            ahead = 0;
+        }
+
+        m_outside = 0;
+
+        if (ahead < m_window)
+        {
+            // Objects skipped in the sequence are missing entirely
+            if (ahead > 0)
+            {
+                m_missing[m_next_sequence] = sequence;
+            }
+            m_next_sequence = sequence + 1;
+            expire();
+        }
+        else if (m_partial.find(sequence) == m_partial.end() &&
+                 !erase_missing(sequence))
+        {
+            // Completed or abandoned
+            return;
+        }
+
+        auto it = m_partial.find(sequence);
+        if (it == m_partial.end())
+        {
+            // Make room by abandoning the oldest partial objects
+            while (m_partial_bytes + object_size > m_max_partial_bytes)
+            {
+                erase_partial(m_partial.begin());
+            }
+
+            it = m_partial.emplace(sequence, partial_object()).first;
+            it->second.m_data.resize(object_size);
+            m_partial_bytes += object_size;
+        }
+
+        auto& object = it->second;
+        if (object.m_data.size() != object_size)
+        {
+            // Inconsistent with the fragments received so far
+            return;
+        }
+
+        insert_range(object, offset, offset + size, data);
+
+        if (object.m_bytes == object_size)
+        {
+            m_partial_bytes -= object_size;
+            m_completed.emplace_back(sequence, std::move(object.m_data));
+            m_partial.erase(it);
+        }
+    }
+
+    /// Remove a partial object
+    void erase_partial(
+        typename std::map<uint32_t, partial_object, serial_less>::iterator it)
+    {
+        m_partial_bytes -= it->second.m_data.size();
+        m_partial.erase(it);
+    }
+
+    /// Remove a sequence number from the missing ranges
+    /// @return true if the sequence number was missing
+    bool erase_missing(uint32_t sequence)
+    {
+        auto it = m_missing.upper_bound(sequence);
+        if (it == m_missing.begin())
+        {
+            return false;
+        }
+
+        --it;
+        auto begin = it->first;
+        auto end = it->second;
+        if (!serial_less()(sequence, end))
+        {
+            return false;
+        }
+
+        m_missing.erase(it);
+        if (begin != sequence)
+        {
+            m_missing[begin] = sequence;
+        }
+        if (sequence + 1 != end)
+        {
+            m_missing[sequence + 1] = end;
+        }
+        return true;
+    }
+
+    /// Abandon the objects which have fallen out of the window
+    void expire()
+    {
+        uint32_t oldest = m_next_sequence - m_window;
+
+        while (!m_missing.empty() &&
+               serial_less()(m_missing.begin()->first, oldest))
+        {
+            auto end = m_missing.begin()->second;
+            m_missing.erase(m_missing.begin());
+
+            if (serial_less()(oldest, end))
+            {
+                m_missing[oldest] = end;
+                break;
+            }
+        }
+
+        while (!m_partial.empty() &&
+               serial_less()(m_partial.begin()->first, oldest))
+        {
+            erase_partial(m_partial.begin());
+        }
+    }
+
+    /// Copy the parts of the range not yet received into the object and
+    /// mark the range as received
+    static void insert_range(partial_object& object, header_type begin,
+                             header_type end, const uint8_t* data)
+    {
+        auto& received = object.m_received;
+
+        // The first range which could touch or overlap the new range
+        auto it = received.upper_bound(begin);
+        if (it != received.begin() && std::prev(it)->second >= begin)
+        {
+            --it;
+        }
+
+        header_type position = begin;
+        header_type merged_begin = begin;
+        header_type merged_end = end;
+
+        while (it != received.end() && it->first <= end)
+        {
+            // Copy the gap before this range
+            if (it->first > position)
+            {
+                std::copy(data + (position - begin), data + (it->first - begin),
+                          object.m_data.begin() + position);
+                object.m_bytes += it->first - position;
+            }
+
+            position = std::max(position, it->second);
+            merged_begin = std::min(merged_begin, it->first);
+            merged_end = std::max(merged_end, it->second);
+            it = received.erase(it);
+        }
+
+        if (position < end)
+        {
+            std::copy(data + (position - begin), data + (end - begin),
+                      object.m_data.begin() + position);
+            object.m_bytes += end - position;
+        }
+
+        received[merged_begin] = merged_end;
+    }
+
+private:
+    /// The size of the largest object accepted
+    header_type m_max_object_size;
+
+    /// The number of sequence numbers kept
+    uint32_t m_window;
+
+    /// The limit on the total size of the partial objects
+    std::size_t m_max_partial_bytes;
+
+    /// The total size of the partial objects
+    std::size_t m_partial_bytes = 0;
+
+    /// True once the first fragment has been received
+    bool m_started = false;
+
+    /// The number of consecutive fragments ahead of the window
+    uint32_t m_outside = 0;
+
+    /// The sequence number after the newest object seen
+    uint32_t m_next_sequence = 0;
+
+    /// Partially received objects
+    std::map<uint32_t, partial_object, serial_less> m_partial;
+
+    /// Ranges of objects of which nothing has been received, as begin and
+    /// end sequence numbers
+    std::map<uint32_t, uint32_t, serial_less> m_missing;
+
+    /// Completed objects waiting to be taken
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> m_completed;
+};
+
+template <class T>
+const T repair_deserializer<T>::header_size;
+
+template <class T>
+const uint32_t repair_deserializer<T>::restart_threshold;
+
+template <class T>
+const T repair_deserializer<T>::default_max_object_size;
+
+template <class T>
+const std::size_t repair_deserializer<T>::default_max_partial_bytes;
+} // namespace chunkie
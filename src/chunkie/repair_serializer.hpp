@@ -0,0 +1,178 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include <endian/big_endian.hpp>
+#include <endian/stream_writer.hpp>
+
+#include "nack.hpp"
+
+namespace chunkie
+{
+/// Serializer writing fragments which can be placed in their object on their
+/// own, allowing lost fragments to be retransmitted selectively.
+///
+/// Every fragment starts with a header holding the sequence number of the
+/// object, the size of the object and the offset of the fragment within it:
+///
+///     | sequence (32 bit) | object size (HeaderType) | offset (HeaderType) |
+///
+/// As with the serializer, a fragment extends to the end of its object or to
+/// the end of its buffer, whichever comes first. The repair_deserializer
+/// reports the ranges it is missing as nacks, and passing these to
+/// set_repair() regenerates just the fragments covering them. Objects must
+/// therefore be kept by the application until they are no longer needed for
+/// repairs.
+template <typename HeaderType = uint32_t>
+class repair_serializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// Max size of the object
+    static const header_type max_object_size =
+        std::numeric_limits<header_type>::max() / 2;
+
+    /// Size of the fragment header
+    static const header_type header_size =
+        sizeof(uint32_t) + 2 * sizeof(header_type);
+
+public:
+    /// @param first_sequence the sequence number of the first object
+    explicit repair_serializer(uint32_t first_sequence = 0) :
+        m_next_sequence(first_sequence)
+    {
+    }
+
+    /// Sets a new object to be processed, it is given the next sequence
+    /// number
+    /// @return the sequence number of the object
+    uint32_t set_object(const uint8_t* object, header_type size)
+    {
+        assert(object != nullptr && "Null pointer provided");
+        assert(size > 0 && "Object is empty");
+        assert(size <= max_object_size && "object too big for header type");
+        assert(m_object == nullptr && "Last object not proccessed");
+
+        auto sequence = m_next_sequence++;
+        set_range(sequence, object, size, 0, size);
+        return sequence;
+    }
+
+    /// Sets a range of a previously set object to be processed again
+    /// @param missing the range to regenerate, of a single object. A nack of
+    ///        several missing objects is repaired one object at a time.
+    /// @param object the object with the sequence number of the nack
+    /// @param size the size of the object
+    void set_repair(const nack<header_type>& missing, const uint8_t* object,
+                    header_type size)
+    {
+        assert(object != nullptr && "Null pointer provided");
+        assert(size > 0 && "Object is empty");
+        assert(m_object == nullptr && "Last object not proccessed");
+        assert(missing.m_count == 1 && "Repair one object at a time");
+        assert((int32_t)(missing.m_sequence - m_next_sequence) < 0 &&
+               "Unknown object");
+        assert(missing.m_offset < size && "Range outside object");
+        assert(missing.m_length <= size - missing.m_offset &&
+               "Range outside object");
+
+        auto length = missing.m_length == 0 ? size - missing.m_offset
+                                            : missing.m_length;
+
+        set_range(missing.m_sequence, object, size, missing.m_offset, length);
+    }
+
+    /// Check if a prevously set object or repair has been completely
+    /// processed
+    bool object_proccessed() const
+    {
+        return m_object == nullptr;
+    }
+
+    /// @return the sequence number the next object will be given
+    uint32_t next_sequence() const
+    {
+        return m_next_sequence;
+    }
+
+    /// @return the maximal number of bytes that can be written to a buffer.
+    header_type max_write_buffer_size() const
+    {
+        assert(m_object != nullptr && "No object set");
+        return header_size + (m_end - m_offset);
+    }
+
+    /// Write size bytes to the provided buffer
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    void write_buffer(uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(m_object != nullptr && "No object set");
+        assert(size > header_size && "Buffer too small for header");
+        assert(size <= max_write_buffer_size() &&
+               "Buffer larger resulting write of all remaining data");
+
+        endian::stream_writer<endian::big_endian> writer(data, size);
+        writer.write(m_sequence);
+        writer.write(m_object_size);
+        writer.write(m_offset);
+
+        auto bytes = (header_type)(size - header_size);
+        writer.write(m_object + m_offset, bytes);
+        m_offset += bytes;
+
+        if (m_offset == m_end)
+        {
+            m_object = nullptr;
+        }
+    }
+
+private:
+    /// Set the range of an object to be processed
+    void set_range(uint32_t sequence, const uint8_t* object, header_type size,
+                   header_type offset, header_type length)
+    {
+        m_sequence = sequence;
+        m_object = object;
+        m_object_size = size;
+        m_offset = offset;
+        m_end = offset + length;
+    }
+
+private:
+    /// The sequence number of the next object, wrapping around
+    uint32_t m_next_sequence;
+
+    /// The sequence number of the current object
+    uint32_t m_sequence = 0;
+
+    /// Current object
+    const uint8_t* m_object = nullptr;
+
+    /// Size of the object
+    header_type m_object_size = 0;
+
+    /// The offset of the next fragment
+    header_type m_offset = 0;
+
+    /// The end of the range being processed
+    header_type m_end = 0;
+};
+
+template <class T>
+const T repair_serializer<T>::max_object_size;
+
+template <class T>
+const T repair_serializer<T>::header_size;
+} // namespace chunkie
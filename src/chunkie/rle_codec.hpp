@@ -0,0 +1,164 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace chunkie
+{
+/// A fast, dependency free run-length codec for use with the
+/// transform_serializer and transform_deserializer.
+///
+/// The encoding is a sequence of runs, each starting with a control byte c.
+/// If c is below 128, c + 1 literal bytes follow. Otherwise the single byte
+/// that follows is repeated c - 128 + 3 times. Runs of zeros and other
+/// repeated bytes, common in sensor frames and padded records, shrink to two
+/// bytes per 130 bytes, while incompressible data grows by at most one byte
+/// per 128 bytes.
+struct rle_codec
+{
+    /// The shortest repeat encoded as a run
+    static const std::size_t min_run = 3;
+
+    /// The longest repeat encoded as a single run
+    static const std::size_t max_run = 127 + min_run;
+
+    /// The longest literal encoded as a single run
+    static const std::size_t max_literal = 128;
+
+    /// Encode data
+    /// @param data the data to encode
+    /// @param size the size of the data
+    /// @param output the buffer to write the encoding to
+    /// @param capacity the size of the output buffer
+    /// @return the size of the encoding, or 0 if it does not fit in capacity
+    static std::size_t encode(const uint8_t* data, std::size_t size,
+                              uint8_t* output, std::size_t capacity)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(output != nullptr && "Null pointer provided");
+
+        std::size_t in = 0;
+        std::size_t out = 0;
+        std::size_t literal = 0;
+
+        while (in < size)
+        {
+            std::size_t run = 1;
+            while (in + run < size && run < max_run &&
+                   data[in + run] == data[in])
+            {
+                run++;
+            }
+
+            if (run < min_run)
+            {
+                in += run;
+                literal += run;
+
+                if (literal >= max_literal)
+                {
+                    if (!put_literal(data + in - literal, max_literal, output,
+                                     capacity, out))
+                    {
+                        return 0;
+                    }
+                    literal -= max_literal;
+                }
+                continue;
+            }
+
+            if (literal > 0 &&
+                !put_literal(data + in - literal, literal, output, capacity,
+                             out))
+            {
+                return 0;
+            }
+            literal = 0;
+
+            if (out + 2 > capacity)
+            {
+                return 0;
+            }
+            output[out++] = (uint8_t)(128 + run - min_run);
+            output[out++] = data[in];
+            in += run;
+        }
+
+        if (literal > 0 &&
+            !put_literal(data + in - literal, literal, output, capacity, out))
+        {
+            return 0;
+        }
+
+        return out;
+    }
+
+    /// Decode data
+    /// @param data the encoded data
+    /// @param size the size of the encoded data
+    /// @param output the buffer to decode to
+    /// @param output_size the size of the decoded data
+    /// @return true if the data decoded to exactly output_size bytes
+    static bool decode(const uint8_t* data, std::size_t size, uint8_t* output,
+                       std::size_t output_size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(output != nullptr && "Null pointer provided");
+
+        std::size_t in = 0;
+        std::size_t out = 0;
+
+        while (in < size)
+        {
+            std::size_t control = data[in++];
+
+            if (control < 128)
+            {
+                std::size_t length = control + 1;
+                if (in + length > size || out + length > output_size)
+                {
+                    return false;
+                }
+                std::memcpy(output + out, data + in, length);
+                in += length;
+                out += length;
+                continue;
+            }
+
+            std::size_t length = control - 128 + min_run;
+            if (in + 1 > size || out + length > output_size)
+            {
+                return false;
+            }
+            std::memset(output + out, data[in], length);
+            in += 1;
+            out += length;
+        }
+
+        return out == output_size;
+    }
+
+private:
+    /// Write a literal run, which must not be larger than max_literal
+    static bool put_literal(const uint8_t* data, std::size_t size,
+                            uint8_t* output, std::size_t capacity,
+                            std::size_t& out)
+    {
+        if (out + 1 + size > capacity)
+        {
+            return false;
+        }
+
+        output[out++] = (uint8_t)(size - 1);
+        std::memcpy(output + out, data, size);
+        out += size;
+        return true;
+    }
+};
+} // namespace chunkie
@@ -12,6 +12,10 @@
 
 #include <bitter/msb0_writer.hpp>
 
+#include "no_extension.hpp"
+#include "object_view.hpp"
+#include "standard_copy.hpp"
+
 namespace chunkie
 {
 
@@ -34,13 +38,28 @@ namespace chunkie
 /// A HeaderType of uint32_t is default and typically supports large enough
 /// objects. If objects a small a smaller header type can be used to reduce
 /// the added overhead.
-template <typename HeaderType = uint32_t>
+///
+/// The Extension template parameter adds a start header extension, see
+/// no_extension, written after the header of the first fragment of every
+/// object. The deserializer must use the same extension.
+///
+/// The CopyPolicy template parameter selects how object data is copied to
+/// the buffers, see standard_copy, streaming_copy, prefetch_copy and
+/// threshold_copy.
+template <typename HeaderType = uint32_t, typename Extension = no_extension,
+          typename CopyPolicy = standard_copy>
 class serializer
 {
 public:
     /// typedef
     using header_type = HeaderType;
 
+    /// The start header extension
+    using extension_type = Extension;
+
+    /// The copy policy
+    using copy_policy_type = CopyPolicy;
+
     /// Max size of the object
     static const header_type max_object_size;
 
@@ -64,6 +83,48 @@ public:
         m_object = object;
         m_object_size = size;
         m_object_remaining = size;
+
+        m_extension.on_set_object();
+    }
+
+    /// Sets an object made of several segments to be processed, the
+    /// segments are written as one object in the given order.
+    /// The segments, and the array of them, must stay alive until the object
+    /// has been processed.
+    /// @param segments the segments of the object, empty segments are allowed
+    /// @param count the number of segments
+    void set_object(const object_view<header_type>* segments,
+                    std::size_t count)
+    {
+        assert(segments != nullptr && "Null pointer provided");
+        assert(count > 0 && "No segments");
+        assert(m_object == nullptr && "Last object not proccessed");
+
+        std::size_t size = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert((segments[i].m_data != nullptr || segments[i].m_size == 0) &&
+                   "Null pointer provided");
+            size += segments[i].m_size;
+        }
+
+        assert(size > 0 && "Object is empty");
+        assert(size <= max_object_size && "object too big for header type");
+
+        // m_object marks the object as set, so it must not be set from an
+        // empty segment which may be a null pointer
+        while (segments->m_size == 0)
+        {
+            ++segments;
+        }
+
+        m_segment = segments;
+        m_segment_remaining = segments->m_size;
+        m_object = segments->m_data;
+        m_object_size = (header_type)size;
+        m_object_remaining = (header_type)size;
+
+        m_extension.on_set_object();
     }
 
     /// Check if a prevously set object has been completely processed
@@ -78,7 +139,78 @@ public:
     header_type max_write_buffer_size() const
     {
         assert(m_object != nullptr && "No object set");
-        return header_size + m_object_remaining;
+        return header_size + start_extension_size() + m_object_remaining;
+    }
+
+    /// @param max_buffer_size the maximum size of a buffer, larger than the
+    ///        headers of a buffer
+    /// @return the smallest number of buffers the rest of the object can be
+    ///         written to
+    header_type buffer_count(header_type max_buffer_size) const
+    {
+        assert(m_object != nullptr && "No object set");
+        assert(max_buffer_size > header_size + start_extension_size() &&
+               "Buffer too small for header");
+
+        std::size_t payload = m_object_remaining + start_extension_size();
+        std::size_t capacity = max_buffer_size - header_size;
+        return (header_type)((payload + capacity - 1) / capacity);
+    }
+
+    /// Size the next buffer so the rest of the object is spread evenly over
+    /// buffer_count() buffers, instead of filling buffers up to
+    /// max_buffer_size and leaving a small last buffer.
+    /// @param max_buffer_size the maximum size of a buffer, larger than the
+    ///        headers of a buffer
+    /// @return the size of the next buffer
+    header_type balanced_buffer_size(header_type max_buffer_size) const
+    {
+        std::size_t count = buffer_count(max_buffer_size);
+        std::size_t total = m_object_remaining + start_extension_size() +
+                            count * header_size;
+        std::size_t size = (total + count - 1) / count;
+
+        // The first buffer must hold the extension and some data
+        size = std::max<std::size_t>(size,
+                                     header_size + start_extension_size() + 1);
+        return (header_type)std::min<std::size_t>(size,
+                                                  max_write_buffer_size());
+    }
+
+    /// @return the start header extension of the current object
+    extension_type& extension()
+    {
+        return m_extension;
+    }
+
+    /// @return the start header extension of the current object
+    const extension_type& extension() const
+    {
+        return m_extension;
+    }
+
+    /// Acquire a buffer from a pool, such as the buffer_pool, and write as
+    /// much as fits to it
+    /// @param pool the pool providing acquire() and buffer_size(), its
+    ///        buffers must be larger than the headers of a buffer
+    /// @param size set to the number of bytes written
+    /// @return the buffer, to be released to the pool once it has been
+    ///         sent, or nullptr if the pool has no free buffer
+    template <class Pool>
+    uint8_t* write_pooled_buffer(Pool& pool, header_type& size)
+    {
+        assert(m_object != nullptr && "No object set");
+
+        uint8_t* data = pool.acquire();
+        if (data == nullptr)
+        {
+            return nullptr;
+        }
+
+        size = (header_type)std::min<std::size_t>(pool.buffer_size(),
+                                                  max_write_buffer_size());
+        write_buffer(data, size);
+        return data;
     }
 
     /// Write size bytes to the provided buffer
@@ -88,10 +220,11 @@ public:
     void write_buffer(uint8_t* data, header_type size)
     {
         assert(data != nullptr && "Null pointer provided");
-        assert(size > header_size && "Buffer too small for header");
+        assert(m_object != nullptr && "No object set");
+        assert(size > header_size + start_extension_size() &&
+               "Buffer too small for header");
         assert(size <= max_write_buffer_size() &&
                "Buffer larger resulting write of all remaining data");
-        assert(m_object != nullptr && "No object set");
 
         endian::stream_writer<endian::big_endian> writer(data, size);
 
@@ -101,11 +234,27 @@ public:
         header.template field<1>(m_object_remaining);
 
         writer.write(header.data());
-        auto bytes =
-            std::min<header_type>(size - header_size, m_object_remaining);
 
-        writer.write(m_object, bytes);
-        m_object += bytes;
+        if (start && extension_type::size > 0)
+        {
+            m_extension.write(writer.remaining_data());
+            writer.skip(extension_type::size);
+        }
+
+        auto bytes = std::min<header_type>(
+            (header_type)writer.remaining_size(), m_object_remaining);
+
+        if (m_segment == nullptr)
+        {
+            copy_policy_type::copy(writer.remaining_data(), m_object, bytes,
+                                   m_object_size);
+            m_object += bytes;
+        }
+        else
+        {
+            write_segments(writer.remaining_data(), bytes);
+        }
+        writer.skip(bytes);
         m_object_remaining -= bytes;
 
         // object done
@@ -113,9 +262,41 @@ public:
         {
             m_object = nullptr;
             m_object_size = 0;
+            m_segment = nullptr;
+        }
+    }
+
+private:
+    /// Copy bytes from the segments, moving on to the next segment whenever
+    /// one is exhausted
+    void write_segments(uint8_t* data, header_type bytes)
+    {
+        while (bytes > 0)
+        {
+            while (m_segment_remaining == 0)
+            {
+                ++m_segment;
+                m_object = m_segment->m_data;
+                m_segment_remaining = m_segment->m_size;
+            }
+
+            auto size = std::min<header_type>(bytes, m_segment_remaining);
+            copy_policy_type::copy(data, m_object, size, m_object_size);
+            data += size;
+            bytes -= size;
+            m_object += size;
+            m_segment_remaining -= size;
         }
     }
 
+    /// @return the size of the extension in the next buffer
+    header_type start_extension_size() const
+    {
+        return m_object_remaining == m_object_size
+                   ? (header_type)extension_type::size
+                   : 0;
+    }
+
 private:
     /// Current object
     const uint8_t* m_object = nullptr;
@@ -125,13 +306,23 @@ private:
 
     /// Remaining objects
     header_type m_object_remaining = 0;
+
+    /// The current segment, or nullptr if the object is contiguous
+    const object_view<header_type>* m_segment = nullptr;
+
+    /// The bytes of the current segment not yet written
+    header_type m_segment_remaining = 0;
+
+    /// The start header extension
+    extension_type m_extension;
 };
 
 /// max_object_size set to half of the max size in value of a class T
-template <class T>
-const T serializer<T>::max_object_size = std::numeric_limits<T>::max() / 2;
+template <class T, class E, class C>
+const T serializer<T, E, C>::max_object_size =
+    std::numeric_limits<T>::max() / 2;
 
 /// max_object_size set to the max size in bytes of a class T
-template <class T>
-const T serializer<T>::header_size = sizeof(T);
+template <class T, class E, class C>
+const T serializer<T, E, C>::header_size = sizeof(T);
 } // namespace chunkie
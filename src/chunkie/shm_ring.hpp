@@ -0,0 +1,478 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "error.hpp"
+
+namespace chunkie
+{
+/// Single-producer single-consumer ring of buffers in a shared memory
+/// segment, for streaming serialized buffers between two processes on the
+/// same host without copying them through the kernel.
+///
+/// One process creates the ring and writes buffers, the serializer writing
+/// directly into the slots through prepare() and commit(). The other process
+/// opens the ring by name and reads the buffers in place through peek() and
+/// release(), handing them directly to a deserializer. The ring positions
+/// are lock-free atomics in the segment. A side that finds the ring empty or
+/// full can sleep on a futex, and is only woken with a system call when it
+/// has announced that it is sleeping.
+///
+/// Available on Linux.
+class shm_ring
+{
+public:
+    /// Identifies a segment holding a ring
+    static const uint64_t magic = 0x6368756e6b726e67ULL;
+
+    /// The alignment of the control block and the slots
+    static const std::size_t cache_line_size = 64;
+
+    /// The size of the length prefix of every slot
+    static const std::size_t slot_header_size = 4;
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2,
+                  "The ring needs lock-free atomics to be shared");
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "Futex words must be plain 32 bit integers");
+
+private:
+    /// The control block at the start of the segment
+    struct control
+    {
+        uint64_t m_magic;
+        uint64_t m_slot_size;
+        uint64_t m_slot_count;
+        uint64_t m_segment_size;
+
+        /// Written by the producer
+        alignas(cache_line_size) std::atomic<uint32_t> m_tail;
+        std::atomic<uint32_t> m_closed;
+        std::atomic<uint32_t> m_writer_waiting;
+        std::atomic<uint32_t> m_writer_signal;
+
+        /// Written by the consumer
+        alignas(cache_line_size) std::atomic<uint32_t> m_head;
+        std::atomic<uint32_t> m_reader_waiting;
+        std::atomic<uint32_t> m_reader_signal;
+    };
+
+public:
+    shm_ring() = default;
+    shm_ring(const shm_ring&) = delete;
+    shm_ring& operator=(const shm_ring&) = delete;
+
+    ~shm_ring()
+    {
+        if (is_open())
+        {
+            close();
+        }
+    }
+
+    /// Create a new ring, the calling process becomes the producer
+    /// @param name the name of the shared memory segment, e.g. "/capture"
+    /// @param slot_size the maximum size of a buffer
+    /// @param slot_count the number of slots, must be a power of two
+    void create(const std::string& name, std::size_t slot_size,
+                uint32_t slot_count, std::error_code& error)
+    {
+        assert(!is_open() && "Ring already open");
+        assert(slot_size > 0 && "Slots must have a size");
+        assert(slot_count > 0 && (slot_count & (slot_count - 1)) == 0 &&
+               "Slot count must be a power of two");
+        assert(slot_count <= (1U << 31) && "Too many slots");
+
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return;
+        }
+
+        std::size_t stride = slot_stride(slot_size);
+        std::size_t size = control_size() + stride * slot_count;
+
+        if (::ftruncate(fd, (off_t)size) != 0 || !map(fd, size, error))
+        {
+            if (!error)
+            {
+                error = std::error_code(errno, std::generic_category());
+            }
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return;
+        }
+        ::close(fd);
+
+        // The segment is zero filled, which is the initial state of the
+        // positions and flags
+        m_control->m_slot_size = slot_size;
+        m_control->m_slot_count = slot_count;
+        m_control->m_segment_size = size;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_control->m_magic = magic;
+
+        init(slot_size, slot_count);
+    }
+
+    /// Open a ring created by another process, the calling process becomes
+    /// the consumer
+    /// @param name the name of the shared memory segment
+    void open(const std::string& name, std::error_code& error)
+    {
+        assert(!is_open() && "Ring already open");
+
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return;
+        }
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            ::close(fd);
+            return;
+        }
+
+        std::size_t size = (std::size_t)status.st_size;
+        if (size < control_size())
+        {
+            error = chunkie::error::invalid_ring;
+            ::close(fd);
+            return;
+        }
+
+        bool mapped = map(fd, size, error);
+        ::close(fd);
+        if (!mapped)
+        {
+            return;
+        }
+
+        uint64_t slot_count = m_control->m_slot_count;
+        if (m_control->m_magic != magic || m_control->m_segment_size != size ||
+            slot_count == 0 || slot_count > (1U << 31) ||
+            (slot_count & (slot_count - 1)) != 0 ||
+            control_size() + slot_stride(m_control->m_slot_size) *
+                                 m_control->m_slot_count !=
+                size)
+        {
+            error = chunkie::error::invalid_ring;
+            close();
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        init(m_control->m_slot_size, (uint32_t)m_control->m_slot_count);
+        m_position = m_control->m_head.load(std::memory_order_acquire);
+        m_cache = m_position;
+    }
+
+    /// Unmap the ring, the segment stays until removed
+    void close()
+    {
+        assert(is_open() && "Ring not open");
+
+        ::munmap(m_control, m_segment_size);
+        m_control = nullptr;
+        m_slots = nullptr;
+    }
+
+    /// Remove the named segment, rings already open stay usable
+    static void remove(const std::string& name, std::error_code& error)
+    {
+        if (::shm_unlink(name.c_str()) != 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+        }
+    }
+
+    /// @return true if the ring is open
+    bool is_open() const
+    {
+        return m_control != nullptr;
+    }
+
+    /// @return the maximum size of a buffer
+    std::size_t slot_size() const
+    {
+        return m_slot_size;
+    }
+
+    /// @return the number of slots
+    uint32_t slot_count() const
+    {
+        return m_mask + 1;
+    }
+
+    /// Reserve the next slot. Must only be called by the producer.
+    /// @return pointer to slot_size() bytes to write the buffer to, or
+    ///         nullptr if the ring is full
+    uint8_t* prepare()
+    {
+        assert(is_open() && "Ring not open");
+
+        if (m_position - m_cache > m_mask)
+        {
+            m_cache = m_control->m_head.load(std::memory_order_acquire);
+            if (m_position - m_cache > m_mask)
+            {
+                return nullptr;
+            }
+        }
+
+        return slot(m_position) + slot_header_size;
+    }
+
+    /// Publish the buffer written to the slot returned by prepare()
+    /// @param size the size of the buffer
+    void commit(std::size_t size)
+    {
+        assert(size > 0 && size <= m_slot_size && "Invalid size");
+        assert(m_position - m_cache <= m_mask && "No slot prepared");
+
+        uint32_t length = (uint32_t)size;
+        std::memcpy(slot(m_position), &length, sizeof(length));
+
+        m_position++;
+        m_control->m_tail.store(m_position, std::memory_order_seq_cst);
+
+        if (m_control->m_reader_waiting.load(std::memory_order_seq_cst))
+        {
+            signal(m_control->m_reader_signal);
+        }
+    }
+
+    /// Sleep until a slot can be prepared. Must only be called by the
+    /// producer.
+    void wait_writable()
+    {
+        while (prepare() == nullptr)
+        {
+            m_control->m_writer_waiting.store(1, std::memory_order_seq_cst);
+            auto value =
+                m_control->m_writer_signal.load(std::memory_order_seq_cst);
+
+            if (m_position - m_control->m_head.load(std::memory_order_seq_cst) >
+                m_mask)
+            {
+                futex_wait(m_control->m_writer_signal, value);
+            }
+
+            m_control->m_writer_waiting.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// Tell the consumer that no more buffers will be written. Must only be
+    /// called by the producer.
+    void shutdown()
+    {
+        m_control->m_closed.store(1, std::memory_order_seq_cst);
+        signal(m_control->m_reader_signal);
+    }
+
+    /// Read the oldest buffer in place. Must only be called by the consumer.
+    /// @param size set to the size of the buffer
+    /// @param error set to invalid_ring if the length of the slot is larger
+    ///        than the slot size, the ring is then unusable
+    /// @return pointer to the buffer, valid until release(), or nullptr if
+    ///         the ring is empty or invalid
+    const uint8_t* peek(std::size_t& size, std::error_code& error)
+    {
+        assert(is_open() && "Ring not open");
+
+        if (m_position == m_cache)
+        {
+            m_cache = m_control->m_tail.load(std::memory_order_acquire);
+            if (m_position == m_cache)
+            {
+                return nullptr;
+            }
+        }
+
+        uint32_t length;
+        std::memcpy(&length, slot(m_position), sizeof(length));
+        if (length > m_slot_size)
+        {
+            error = chunkie::error::invalid_ring;
+            return nullptr;
+        }
+
+        size = length;
+        return slot(m_position) + slot_header_size;
+    }
+
+    /// Hand the buffer returned by peek() back to the producer
+    void release()
+    {
+        assert(m_position != m_cache && "No buffer peeked");
+
+        m_position++;
+        m_control->m_head.store(m_position, std::memory_order_seq_cst);
+
+        if (m_control->m_writer_waiting.load(std::memory_order_seq_cst))
+        {
+            signal(m_control->m_writer_signal);
+        }
+    }
+
+    /// Sleep until a buffer can be peeked. Must only be called by the
+    /// consumer.
+    /// @return false if the ring is empty and the producer has shut down,
+    ///         true if a buffer can be peeked or peek() reports an error
+    bool wait_readable()
+    {
+        std::size_t size;
+        std::error_code error;
+        while (peek(size, error) == nullptr)
+        {
+            if (error)
+            {
+                return true;
+            }
+
+            m_control->m_reader_waiting.store(1, std::memory_order_seq_cst);
+            auto value =
+                m_control->m_reader_signal.load(std::memory_order_seq_cst);
+
+            bool empty = m_control->m_tail.load(std::memory_order_seq_cst) ==
+                         m_position;
+            bool closed = m_control->m_closed.load(std::memory_order_seq_cst);
+
+            if (empty && !closed)
+            {
+                futex_wait(m_control->m_reader_signal, value);
+            }
+
+            m_control->m_reader_waiting.store(0, std::memory_order_relaxed);
+
+            if (empty && closed)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @return the number of futex wake ups issued by this side
+    uint64_t wake_ups() const
+    {
+        return m_wake_ups;
+    }
+
+private:
+    /// Map the segment
+    bool map(int fd, std::size_t size, std::error_code& error)
+    {
+        void* memory =
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return false;
+        }
+
+        m_control = static_cast<control*>(memory);
+        m_segment_size = size;
+        return true;
+    }
+
+    /// Set up the local state of a mapped ring
+    void init(std::size_t slot_size, uint32_t slot_count)
+    {
+        m_slots = reinterpret_cast<uint8_t*>(m_control) + control_size();
+        m_slot_size = slot_size;
+        m_stride = slot_stride(slot_size);
+        m_mask = slot_count - 1;
+        m_position = 0;
+        m_cache = 0;
+    }
+
+    /// @return the slot at a position
+    uint8_t* slot(uint32_t position) const
+    {
+        return m_slots + (position & m_mask) * m_stride;
+    }
+
+    /// Wake the other side sleeping on a signal word
+    void signal(std::atomic<uint32_t>& word)
+    {
+        word.fetch_add(1, std::memory_order_seq_cst);
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE,
+                  1, nullptr, nullptr, 0);
+        m_wake_ups++;
+    }
+
+    /// Sleep while a signal word holds value
+    static void futex_wait(std::atomic<uint32_t>& word, uint32_t value)
+    {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT,
+                  value, nullptr, nullptr, 0);
+    }
+
+    /// @return the size of the control block
+    static std::size_t control_size()
+    {
+        return (sizeof(control) + cache_line_size - 1) / cache_line_size *
+               cache_line_size;
+    }
+
+    /// @return the distance between slots
+    static std::size_t slot_stride(std::size_t slot_size)
+    {
+        return (slot_header_size + slot_size + cache_line_size - 1) /
+               cache_line_size * cache_line_size;
+    }
+
+private:
+    /// The mapped segment
+    control* m_control = nullptr;
+
+    /// The size of the mapped segment
+    std::size_t m_segment_size = 0;
+
+    /// The first slot
+    uint8_t* m_slots = nullptr;
+
+    /// The maximum size of a buffer
+    std::size_t m_slot_size = 0;
+
+    /// The distance between slots
+    std::size_t m_stride = 0;
+
+    /// The number of slots minus one
+    uint32_t m_mask = 0;
+
+    /// The position of this side, the tail for the producer and the head
+    /// for the consumer
+    uint32_t m_position = 0;
+
+    /// The last seen position of the other side
+    uint32_t m_cache = 0;
+
+    /// The number of futex wake ups issued
+    uint64_t m_wake_ups = 0;
+};
+} // namespace chunkie
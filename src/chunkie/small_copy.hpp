@@ -0,0 +1,70 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// The moves are bounded by size, but once inlined GCC may not see this and
+// warn about the fixed size moves into small destinations
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+
+namespace chunkie
+{
+/// Copy a small number of bytes using fixed-width moves.
+///
+/// Every copy is made of at most a few fixed size, possibly overlapping,
+/// moves, which the compiler turns into single vector or scalar loads and
+/// stores (SSE/AVX on x86, NEON on ARM) instead of a call to a variable
+/// length memcpy. Neither the source nor the destination is accessed
+/// outside of the size bytes, so the copy is safe at the end of buffers.
+inline void small_copy(uint8_t* destination, const uint8_t* source,
+                       std::size_t size)
+{
+    if (size >= 32)
+    {
+        std::size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32)
+        {
+            std::memcpy(destination + offset, source + offset, 32);
+        }
+
+        if (offset < size)
+        {
+            std::memcpy(destination + size - 32, source + size - 32, 32);
+        }
+    }
+    else if (size >= 16)
+    {
+        std::memcpy(destination, source, 16);
+        std::memcpy(destination + size - 16, source + size - 16, 16);
+    }
+    else if (size >= 8)
+    {
+        std::memcpy(destination, source, 8);
+        std::memcpy(destination + size - 8, source + size - 8, 8);
+    }
+    else if (size >= 4)
+    {
+        std::memcpy(destination, source, 4);
+        std::memcpy(destination + size - 4, source + size - 4, 4);
+    }
+    else if (size > 0)
+    {
+        destination[0] = source[0];
+        destination[size / 2] = source[size / 2];
+        destination[size - 1] = source[size - 1];
+    }
+}
+} // namespace chunkie
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace chunkie
+{
+/// Bounded lock-free queue with a single producer and a single consumer
+/// thread.
+template <typename ValueType>
+class spsc_queue
+{
+public:
+    /// Type def
+    using value_type = ValueType;
+
+public:
+    /// @param capacity the number of values the queue can hold, must be a
+    ///        power of two
+    explicit spsc_queue(std::size_t capacity) :
+        m_values(capacity), m_mask(capacity - 1)
+    {
+        assert(capacity > 0 && "Queue must have capacity");
+        assert((capacity & m_mask) == 0 && "Capacity must be a power of two");
+    }
+
+    /// Push a value onto the queue. Must only be called by the producer.
+    /// @return false if the queue is full, in which case value is untouched
+    bool try_push(value_type& value)
+    {
+        auto tail = m_tail.m_position.load(std::memory_order_relaxed);
+
+        if (tail - m_tail.m_cache == m_values.size())
+        {
+            m_tail.m_cache = m_head.m_position.load(std::memory_order_acquire);
+            if (tail - m_tail.m_cache == m_values.size())
+            {
+                return false;
+            }
+        }
+
+        m_values[tail & m_mask] = std::move(value);
+        m_tail.m_position.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop a value from the queue. Must only be called by the consumer.
+    /// @return false if the queue is empty
+    bool try_pop(value_type& value)
+    {
+        auto head = m_head.m_position.load(std::memory_order_relaxed);
+
+        if (head == m_head.m_cache)
+        {
+            m_head.m_cache = m_tail.m_position.load(std::memory_order_acquire);
+            if (head == m_head.m_cache)
+            {
+                return false;
+            }
+        }
+
+        value = std::move(m_values[head & m_mask]);
+        m_head.m_position.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @return true if the queue is empty, only exact when called by the
+    ///         consumer
+    bool empty() const
+    {
+        return m_head.m_position.load(std::memory_order_acquire) ==
+               m_tail.m_position.load(std::memory_order_acquire);
+    }
+
+    /// @return the number of values the queue can hold
+    std::size_t capacity() const
+    {
+        return m_values.size();
+    }
+
+private:
+    /// Position in the ring written by one side and read by the other,
+    /// padded to keep the two sides on separate cache lines
+    struct cursor
+    {
+        uint8_t m_padding[64];
+
+        /// The position owned by this side
+        std::atomic<std::size_t> m_position{0};
+
+        /// This side's last observed position of the other side
+        std::size_t m_cache = 0;
+    };
+
+private:
+    /// The ring of values
+    std::vector<value_type> m_values;
+
+    /// Mask mapping a position to an index in the ring
+    const std::size_t m_mask;
+
+    /// Next position to pop, written by the consumer
+    cursor m_head;
+
+    /// Next position to push, written by the producer
+    cursor m_tail;
+};
+} // namespace chunkie
@@ -0,0 +1,30 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace chunkie
+{
+/// The default copy policy of the serializer and deserializer, using a plain
+/// memcpy.
+///
+/// A copy policy moves the object data between objects and buffers. Its
+/// copy() function is called with the destination, the source, the number
+/// of bytes to copy and the size of the whole object being copied, which
+/// lets a policy pick a strategy for the object rather than for each part.
+struct standard_copy
+{
+    /// Copy size bytes from source to destination
+    static void copy(uint8_t* destination, const uint8_t* source,
+                     std::size_t size, std::size_t object_size)
+    {
+        (void)object_size;
+        std::memcpy(destination, source, size);
+    }
+};
+} // namespace chunkie
@@ -0,0 +1,75 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHUNKIE_STREAMING_COPY_AVAILABLE
+#endif
+
+namespace chunkie
+{
+/// Copy policy writing the destination with non-temporal stores.
+///
+/// The stores bypass the cache, so copying a huge object neither evicts the
+/// working set of the application nor of other threads sharing the cache.
+/// This pays off when the destination is not read again soon, but makes
+/// reading it right after the copy slower. Copies smaller than
+/// min_streaming_size use memcpy.
+///
+/// Non-temporal stores are used on x86 with SSE2, other platforms fall back
+/// to memcpy.
+struct streaming_copy
+{
+    /// The smallest copy made with non-temporal stores
+    static const std::size_t min_streaming_size = 256;
+
+    /// Copy size bytes from source to destination
+    static void copy(uint8_t* destination, const uint8_t* source,
+                     std::size_t size, std::size_t object_size)
+    {
+        (void)object_size;
+
+#if defined(CHUNKIE_STREAMING_COPY_AVAILABLE)
+        if (size >= min_streaming_size)
+        {
+            // Copy the head with memcpy to align the destination
+            std::size_t head = (16 - ((uintptr_t)destination & 15)) & 15;
+            std::memcpy(destination, source, head);
+
+            std::size_t offset = head;
+            for (; offset + 64 <= size; offset += 64)
+            {
+                auto s = reinterpret_cast<const __m128i*>(source + offset);
+                auto d = reinterpret_cast<__m128i*>(destination + offset);
+
+                __m128i a = _mm_loadu_si128(s);
+                __m128i b = _mm_loadu_si128(s + 1);
+                __m128i c = _mm_loadu_si128(s + 2);
+                __m128i e = _mm_loadu_si128(s + 3);
+                _mm_stream_si128(d, a);
+                _mm_stream_si128(d + 1, b);
+                _mm_stream_si128(d + 2, c);
+                _mm_stream_si128(d + 3, e);
+            }
+
+            std::memcpy(destination + offset, source + offset, size - offset);
+
+            // Order the streaming stores before any following store, such as
+            // the one handing the object to another thread
+            _mm_sfence();
+            return;
+        }
+#endif
+
+        std::memcpy(destination, source, size);
+    }
+};
+} // namespace chunkie
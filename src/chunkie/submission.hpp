@@ -0,0 +1,42 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace chunkie
+{
+/// An object submitted to a submission_serializer.
+///
+/// The submission is owned by the producer and refers to the object without
+/// copying it. Both must stay alive and unchanged until completed() returns
+/// true, after which the submission and the object can be reused.
+struct submission
+{
+    submission() = default;
+    submission(const submission&) = delete;
+    submission& operator=(const submission&) = delete;
+
+    /// @return true once the whole object has been written to buffers
+    bool completed() const
+    {
+        return m_completed.load(std::memory_order_acquire);
+    }
+
+    /// The object
+    const uint8_t* m_data = nullptr;
+
+    /// The size of the object
+    std::size_t m_size = 0;
+
+    /// Set when the object has been written
+    std::atomic<bool> m_completed{true};
+
+    /// The next submission in the queue
+    std::atomic<submission*> m_next{nullptr};
+};
+} // namespace chunkie
@@ -0,0 +1,120 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include "mpsc_queue.hpp"
+#include "serializer.hpp"
+#include "submission.hpp"
+
+namespace chunkie
+{
+/// Serializer accepting objects from many threads.
+///
+/// Producers submit objects with submit(), which is lock-free and never
+/// blocks. A single consumer thread calls write_buffer() to pack the
+/// submitted objects, in the order they were submitted, into buffers in the
+/// serializer format. When the last part of an object has been written its
+/// submission is marked completed, telling the producer that the object
+/// memory can be reused.
+template <typename HeaderType = uint32_t>
+class submission_serializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The serializer packing the objects
+    using serializer_type = serializer<header_type>;
+
+public:
+    /// Submit an object. May be called by any thread.
+    /// @param object the submission, its m_data and m_size must be set and
+    ///        it must not be in use by a previous submit()
+    void submit(submission& object)
+    {
+        assert(object.m_data != nullptr && "Null pointer provided");
+        assert(object.m_size > 0 && "Object is empty");
+        assert(object.m_size <= serializer_type::max_object_size &&
+               "object too big for header type");
+        assert(object.completed() && "Submission already in use");
+
+        object.m_completed.store(false, std::memory_order_relaxed);
+        m_queue.push(&object);
+    }
+
+    /// Fill a buffer with submitted objects. Must only be called by the
+    /// consumer.
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    /// @return the number of bytes written, less than size if there were
+    ///         not enough submitted objects to fill the buffer
+    header_type write_buffer(uint8_t* data, header_type size)
+    {
+        assert(data != nullptr && "Null pointer provided");
+
+        header_type written = 0;
+
+        while (size - written > serializer_type::header_size)
+        {
+            if (m_current == nullptr)
+            {
+                m_current = m_queue.pop();
+                if (m_current == nullptr)
+                {
+                    break;
+                }
+
+                m_serializer.set_object(m_current->m_data,
+                                        (header_type)m_current->m_size);
+            }
+
+            auto bytes = std::min<header_type>(
+                size - written, m_serializer.max_write_buffer_size());
+            m_serializer.write_buffer(data + written, bytes);
+            written += bytes;
+
+            if (m_serializer.object_proccessed())
+            {
+                m_current->m_completed.store(true, std::memory_order_release);
+                m_current = nullptr;
+                m_completed++;
+            }
+        }
+
+        return written;
+    }
+
+    /// @return true if an object is partially written or submissions are
+    ///         waiting, only exact when called by the consumer
+    bool has_objects() const
+    {
+        return m_current != nullptr || !m_queue.empty();
+    }
+
+    /// @return the number of objects completely written
+    uint64_t completed_objects() const
+    {
+        return m_completed;
+    }
+
+private:
+    /// The submitted objects
+    mpsc_queue<submission> m_queue;
+
+    /// The serializer
+    serializer_type m_serializer;
+
+    /// The submission being written
+    submission* m_current = nullptr;
+
+    /// The number of objects completely written
+    uint64_t m_completed = 0;
+};
+} // namespace chunkie
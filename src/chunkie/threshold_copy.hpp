@@ -0,0 +1,43 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+#include "standard_copy.hpp"
+#include "streaming_copy.hpp"
+
+namespace chunkie
+{
+/// Copy policy choosing between two policies by the size of the object.
+///
+/// Objects smaller than Threshold bytes are copied with the Small policy,
+/// larger objects with the Large policy. With the defaults, objects of a
+/// megabyte or more are copied with non-temporal stores, as they are
+/// unlikely to fit in the cache anyway, while smaller objects stay in the
+/// cache for the code processing them.
+template <std::size_t Threshold = 1024 * 1024, typename Small = standard_copy,
+          typename Large = streaming_copy>
+struct threshold_copy
+{
+    /// The smallest object copied with the Large policy
+    static const std::size_t threshold = Threshold;
+
+    /// Copy size bytes from source to destination
+    static void copy(uint8_t* destination, const uint8_t* source,
+                     std::size_t size, std::size_t object_size)
+    {
+        if (object_size >= Threshold)
+        {
+            Large::copy(destination, source, size, object_size);
+        }
+        else
+        {
+            Small::copy(destination, source, size, object_size);
+        }
+    }
+};
+} // namespace chunkie
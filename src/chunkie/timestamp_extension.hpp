@@ -0,0 +1,114 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <endian/big_endian.hpp>
+
+#include "latency_histogram.hpp"
+
+namespace chunkie
+{
+/// Start header extension carrying the time an object was set in the
+/// serializer, for measuring the latency of objects end to end.
+///
+/// The serializer stamps every object with the time of set_object(). The
+/// deserializer records the time from then until the start of the object
+/// was read, and until the object was completed, in two histograms
+/// available through deserializer::extension().
+///
+/// Timestamps are nanoseconds since the epoch of the Clock. The default
+/// steady clock is monotonic but only comparable on the same host, use a
+/// synchronized clock such as std::chrono::system_clock across hosts.
+/// Latencies below zero, caused by clock differences, are recorded as zero.
+template <typename Clock = std::chrono::steady_clock>
+class timestamp_extension
+{
+public:
+    /// The clock
+    using clock_type = Clock;
+
+    /// The number of bytes added after a start header
+    static const std::size_t size = sizeof(uint64_t);
+
+public:
+    /// @return the timestamp of the current object
+    uint64_t timestamp() const
+    {
+        return m_timestamp;
+    }
+
+    /// @return the latencies from set_object() in the serializer until the
+    ///         start of the object was read by the deserializer
+    const latency_histogram& time_to_first_fragment() const
+    {
+        return m_time_to_first_fragment;
+    }
+
+    /// @return the latencies from set_object() in the serializer until the
+    ///         object was completed by the deserializer
+    const latency_histogram& time_to_completion() const
+    {
+        return m_time_to_completion;
+    }
+
+    /// Write the extension
+    void write(uint8_t* data) const
+    {
+        endian::big_endian::put<uint64_t>(m_timestamp, data);
+    }
+
+    /// Read the extension
+    void read(const uint8_t* data)
+    {
+        m_timestamp = endian::big_endian::get<uint64_t>(data);
+        m_time_to_first_fragment.record(elapsed());
+    }
+
+    /// Called by the serializer when an object is set
+    void on_set_object()
+    {
+        m_timestamp = now();
+    }
+
+    /// Called by the deserializer when an object is completed
+    void on_object_completed()
+    {
+        m_time_to_completion.record(elapsed());
+    }
+
+private:
+    /// @return the current time in nanoseconds
+    static uint64_t now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   clock_type::now().time_since_epoch())
+            .count();
+    }
+
+    /// @return the nanoseconds since the timestamp
+    uint64_t elapsed() const
+    {
+        auto time = now();
+        return time > m_timestamp ? time - m_timestamp : 0;
+    }
+
+private:
+    /// The timestamp of the current object
+    uint64_t m_timestamp = 0;
+
+    /// Latencies until the start of objects were read
+    latency_histogram m_time_to_first_fragment;
+
+    /// Latencies until objects were completed
+    latency_histogram m_time_to_completion;
+};
+
+template <class C>
+const std::size_t timestamp_extension<C>::size;
+} // namespace chunkie
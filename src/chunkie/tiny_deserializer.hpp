@@ -0,0 +1,84 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include <endian/big_endian.hpp>
+
+#include "object_view.hpp"
+
+namespace chunkie
+{
+/// Splits a buffer of small objects into views in a single sweep.
+///
+/// The objects are not copied, the views point into the buffer. The sweep
+/// stops at the first header which does not start a complete object in the
+/// buffer, such as zero padding or the start of an object continued in the
+/// next buffer. Any data from that point can be passed on to a deserializer.
+template <typename HeaderType = uint8_t>
+class tiny_deserializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// Size of the header
+    static const header_type header_size = sizeof(header_type);
+
+    /// The start bit of the header
+    static const header_type start_bit =
+        std::numeric_limits<header_type>::max() / 2 + 1;
+
+public:
+    /// Read the complete objects at the start of a buffer
+    /// @param data the buffer to read
+    /// @param size the size of the buffer
+    /// @param objects the views to fill
+    /// @param max_objects the number of views available
+    /// @param consumed set to the number of bytes occupied by the objects
+    /// @return the number of objects read
+    std::size_t read_objects(const uint8_t* data, std::size_t size,
+                             object_view<header_type>* objects,
+                             std::size_t max_objects,
+                             std::size_t& consumed) const
+    {
+        assert(data != nullptr && "Null pointer provided");
+        assert(objects != nullptr && "Null pointer provided");
+
+        std::size_t offset = 0;
+        std::size_t count = 0;
+
+        while (count < max_objects && size - offset > header_size)
+        {
+            auto header = endian::big_endian::get<header_type>(data + offset);
+            auto object_size = (header_type)(header & ~start_bit);
+
+            if ((header & start_bit) == 0 || object_size == 0 ||
+                object_size > size - offset - header_size)
+            {
+                break;
+            }
+
+            objects[count].m_data = data + offset + header_size;
+            objects[count].m_size = object_size;
+            offset += header_size + object_size;
+            count++;
+        }
+
+        consumed = offset;
+        return count;
+    }
+};
+
+template <class T>
+const T tiny_deserializer<T>::header_size;
+
+template <class T>
+const T tiny_deserializer<T>::start_bit;
+} // namespace chunkie
@@ -0,0 +1,96 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include <endian/big_endian.hpp>
+
+#include "object_view.hpp"
+#include "small_copy.hpp"
+
+namespace chunkie
+{
+/// Packs batches of small objects into buffers.
+///
+/// Every object is written whole with a start header, exactly as the
+/// serializer would write an object which fits in a buffer, so the buffers
+/// can be read by the deserializer or the tiny_deserializer. Compared to
+/// calling set_object() and write_buffer() once per object, the header is
+/// computed directly and the payload is copied with small_copy, which
+/// matters when the cost per object rather than per byte dominates.
+template <typename HeaderType = uint8_t>
+class tiny_serializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// Max size of an object
+    static const header_type max_object_size =
+        std::numeric_limits<header_type>::max() / 2;
+
+    /// Size of the header
+    static const header_type header_size = sizeof(header_type);
+
+    /// The start bit of the header
+    static const header_type start_bit = max_object_size + 1;
+
+public:
+    /// Write as many objects as fit completely into the buffer
+    /// @param objects the objects to write
+    /// @param count the number of objects
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    /// @param written set to the number of bytes written to the buffer
+    /// @return the number of objects written
+    std::size_t write_objects(const object_view<header_type>* objects,
+                              std::size_t count, uint8_t* data,
+                              std::size_t size, std::size_t& written) const
+    {
+        assert(objects != nullptr && "Null pointer provided");
+        assert(data != nullptr && "Null pointer provided");
+
+        std::size_t offset = 0;
+        std::size_t index = 0;
+
+        for (; index < count; ++index)
+        {
+            const auto& object = objects[index];
+            assert(object.m_data != nullptr && "Null pointer provided");
+            assert(object.m_size > 0 && "Object is empty");
+            assert(object.m_size <= max_object_size &&
+                   "object too big for header type");
+
+            if (size - offset < header_size + (std::size_t)object.m_size)
+            {
+                break;
+            }
+
+            endian::big_endian::put<header_type>(
+                (header_type)(start_bit | object.m_size), data + offset);
+            offset += header_size;
+
+            small_copy(data + offset, object.m_data, object.m_size);
+            offset += object.m_size;
+        }
+
+        written = offset;
+        return index;
+    }
+};
+
+template <class T>
+const T tiny_serializer<T>::max_object_size;
+
+template <class T>
+const T tiny_serializer<T>::header_size;
+
+template <class T>
+const T tiny_serializer<T>::start_bit;
+} // namespace chunkie
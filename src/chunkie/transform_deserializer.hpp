@@ -0,0 +1,126 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "deserializer.hpp"
+#include "rle_codec.hpp"
+#include "transform_extension.hpp"
+
+namespace chunkie
+{
+/// Deserializer reversing the transform applied by a transform_serializer
+/// using the same Codec.
+///
+/// The Codec provides decode(data, size, output, output_size), returning
+/// true if the data decoded to exactly output_size bytes. Objects which were
+/// not transformed are written straight to the provided object. Transformed
+/// objects are collected in a scratch buffer owned by the deserializer and
+/// decoded into the provided object when their last part arrives.
+///
+/// object_size() returns the size of the object before the transform, so
+/// the deserializer is used exactly like the deserializer. An object which
+/// fails to decode is never reported as completed.
+template <typename Codec = rle_codec, typename HeaderType = uint32_t>
+class transform_deserializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The codec
+    using codec_type = Codec;
+
+    /// The deserializer reading the transformed objects
+    using deserializer_type =
+        deserializer<header_type, transform_extension<header_type>>;
+
+public:
+    /// Read from a buffer. buffers must be read in-order,
+    void set_buffer(const uint8_t* data, header_type size)
+    {
+        m_deserializer.set_buffer(data, size);
+    }
+
+    /// @returns true if all data in the set buffer have been processed
+    bool buffer_proccessed() const
+    {
+        return m_deserializer.buffer_proccessed();
+    }
+
+    /// @returns the size of the current object before the transform
+    header_type object_size() const
+    {
+        assert(!buffer_proccessed() &&
+               "No object data available,"
+               "check that buffer is not processed before calling");
+        return m_deserializer.extension().original_size();
+    }
+
+    /// Writes available bytes to the given pointer, which must point to
+    /// object_size() bytes and be the same for all parts of an object.
+    void write_to_object(uint8_t* object)
+    {
+        assert(object != nullptr && "Null pointer provided");
+
+        m_object_completed = false;
+
+        // Writing may read the header of the next object, so the state of
+        // the current object is captured first
+        auto transformed = m_deserializer.extension().transformed();
+        auto original_size = m_deserializer.extension().original_size();
+
+        if (!transformed)
+        {
+            m_deserializer.write_to_object(object);
+            m_object_completed = m_deserializer.object_completed();
+            return;
+        }
+
+        auto size = m_deserializer.object_size();
+        if (m_scratch.size() < size)
+        {
+            m_scratch.resize(size);
+        }
+
+        m_deserializer.write_to_object(m_scratch.data());
+
+        if (m_deserializer.object_completed())
+        {
+            m_object_completed =
+                m_codec.decode(m_scratch.data(), size, object, original_size);
+        }
+    }
+
+    /// @return true if the final part of an object was written
+    bool object_completed() const
+    {
+        return m_object_completed;
+    }
+
+    /// @return the codec
+    codec_type& codec()
+    {
+        return m_codec;
+    }
+
+private:
+    /// The codec
+    codec_type m_codec;
+
+    /// The deserializer
+    deserializer_type m_deserializer;
+
+    /// The transformed part of the current object
+    std::vector<uint8_t> m_scratch;
+
+    /// True if the last write completed an object
+    bool m_object_completed = false;
+};
+} // namespace chunkie
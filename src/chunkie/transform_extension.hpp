@@ -0,0 +1,106 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include <endian/big_endian.hpp>
+
+#include <bitter/msb0_reader.hpp>
+#include <bitter/msb0_writer.hpp>
+
+namespace chunkie
+{
+/// Start header extension describing a transformed object.
+///
+/// The extension has the size of the HeaderType and consists of a bit telling
+/// whether the object was transformed, followed by the size of the object
+/// before the transform. It is used by the transform_serializer and
+/// transform_deserializer.
+template <typename HeaderType = uint32_t>
+class transform_extension
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The number of bytes added after a start header
+    static const std::size_t size = sizeof(header_type);
+
+private:
+    /// The extension consists of a transformed bit and the original size
+    using extension_writer =
+        bitter::msb0_writer<header_type, 1, (sizeof(header_type) * 8) - 1>;
+    using extension_reader =
+        bitter::msb0_reader<header_type, 1, (sizeof(header_type) * 8) - 1>;
+
+public:
+    /// Describe the current object
+    /// @param transformed true if the object was transformed
+    /// @param original_size the size of the object before the transform
+    void set(bool transformed, header_type original_size)
+    {
+        assert(original_size <= std::numeric_limits<header_type>::max() / 2 &&
+               "Original size too big for header type");
+
+        m_transformed = transformed;
+        m_original_size = original_size;
+    }
+
+    /// @return true if the object was transformed
+    bool transformed() const
+    {
+        return m_transformed;
+    }
+
+    /// @return the size of the object before the transform
+    header_type original_size() const
+    {
+        return m_original_size;
+    }
+
+    /// Write the extension
+    void write(uint8_t* data) const
+    {
+        auto extension = extension_writer();
+        extension.template field<0>(m_transformed);
+        extension.template field<1>(m_original_size);
+        endian::big_endian::put<header_type>(extension.data(), data);
+    }
+
+    /// Read the extension
+    void read(const uint8_t* data)
+    {
+        auto extension =
+            extension_reader(endian::big_endian::get<header_type>(data));
+        m_transformed = extension.template field<0>().template as<bool>();
+        m_original_size =
+            extension.template field<1>().template as<header_type>();
+    }
+
+    /// Called by the serializer when an object is set
+    void on_set_object()
+    {
+    }
+
+    /// Called by the deserializer when an object is completed
+    void on_object_completed()
+    {
+    }
+
+private:
+    /// True if the object was transformed
+    bool m_transformed = false;
+
+    /// The size of the object before the transform
+    header_type m_original_size = 0;
+};
+
+template <class T>
+const std::size_t transform_extension<T>::size;
+} // namespace chunkie
@@ -0,0 +1,131 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "rle_codec.hpp"
+#include "serializer.hpp"
+#include "transform_extension.hpp"
+
+namespace chunkie
+{
+/// Serializer applying a transform, such as compression, to every object
+/// before it is cut into buffers.
+///
+/// The Codec provides encode(data, size, output, capacity), returning the
+/// size of the encoding or 0 if it does not fit in capacity. An object is
+/// only sent transformed if the encoding is smaller than the object,
+/// otherwise it is sent as is. The start header of every object carries a
+/// flag telling which is the case together with the original size, see
+/// transform_extension.
+///
+/// The encoding is written to a scratch buffer owned by the serializer and
+/// reused between objects, so no allocation happens once it has grown to
+/// the size of the largest object.
+template <typename Codec = rle_codec, typename HeaderType = uint32_t>
+class transform_serializer
+{
+public:
+    /// typedef
+    using header_type = HeaderType;
+
+    /// The codec
+    using codec_type = Codec;
+
+    /// The serializer writing the transformed objects
+    using serializer_type =
+        serializer<header_type, transform_extension<header_type>>;
+
+public:
+    /// Sets an object in the serializer to be processed
+    void set_object(const uint8_t* object, header_type size)
+    {
+        assert(object != nullptr && "Null pointer provided");
+        assert(size > 0 && "Object is empty");
+        assert(m_serializer.object_proccessed() &&
+               "Last object not proccessed");
+
+        if (m_scratch.size() < size)
+        {
+            m_scratch.resize(size);
+        }
+
+        // Only use the encoding if it is smaller than the object
+        auto encoded =
+            m_codec.encode(object, size, m_scratch.data(), size - 1);
+
+        if (encoded > 0)
+        {
+            m_serializer.extension().set(true, size);
+            m_serializer.set_object(m_scratch.data(), (header_type)encoded);
+            m_transformed_size = (header_type)encoded;
+        }
+        else
+        {
+            m_serializer.extension().set(false, size);
+            m_serializer.set_object(object, size);
+            m_transformed_size = size;
+        }
+    }
+
+    /// Check if a prevously set object has been completely processed
+    /// @return false if some data from the set object has not been written
+    /// to a buffer
+    bool object_proccessed() const
+    {
+        return m_serializer.object_proccessed();
+    }
+
+    /// @return true if the current object was transformed
+    bool object_transformed() const
+    {
+        return m_serializer.extension().transformed();
+    }
+
+    /// @return the number of bytes of the current object after the
+    ///         transform, which is the original size if it was not transformed
+    header_type transformed_size() const
+    {
+        return m_transformed_size;
+    }
+
+    /// @return the maximal number of bytes that can be written to a buffer.
+    header_type max_write_buffer_size() const
+    {
+        return m_serializer.max_write_buffer_size();
+    }
+
+    /// Write size bytes to the provided buffer
+    /// @param data the buffer to write to
+    /// @param size the size of the buffer
+    void write_buffer(uint8_t* data, header_type size)
+    {
+        m_serializer.write_buffer(data, size);
+    }
+
+    /// @return the codec
+    codec_type& codec()
+    {
+        return m_codec;
+    }
+
+private:
+    /// The codec
+    codec_type m_codec;
+
+    /// The serializer
+    serializer_type m_serializer;
+
+    /// The encoding of the current object
+    std::vector<uint8_t> m_scratch;
+
+    /// The size of the current object after the transform
+    header_type m_transformed_size = 0;
+};
+} // namespace chunkie
@@ -0,0 +1,258 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace chunkie
+{
+/// Receives buffers from a UDP socket in batches.
+///
+/// Each call to receive() reads as many datagrams as are available, up to
+/// the batch size, with a single recvmmsg call. With generic receive offload
+/// (GRO) enabled the kernel may coalesce several datagrams into one message,
+/// which is split back into the original buffers. The buffers are exposed in
+/// place and can be passed straight to deserializer::set_buffer.
+///
+/// Datagrams larger than the maximum buffer size are truncated by the
+/// kernel. These are dropped and counted instead of being passed on.
+///
+/// Available on Linux.
+class udp_receiver
+{
+public:
+    /// The size of a slot when GRO is enabled, large enough for any
+    /// coalesced message
+    static const std::size_t gro_slot_size = 65535;
+
+public:
+    /// @param socket a bound UDP socket, not owned by the receiver
+    /// @param max_buffer_size the maximum size of a buffer
+    /// @param batch_size the number of messages received per call
+    /// @param gro if true, try to enable generic receive offload
+    udp_receiver(int socket, std::size_t max_buffer_size,
+                 std::size_t batch_size, bool gro = false) :
+        m_socket(socket), m_iovecs(batch_size), m_messages(batch_size),
+        m_controls(batch_size * CMSG_SPACE(sizeof(int)))
+    {
+        assert(socket >= 0 && "Invalid socket");
+        assert(max_buffer_size > 0 && "Buffers must have a size");
+        assert(batch_size > 0 && "Batch must hold buffers");
+
+        if (gro)
+        {
+            int enable = 1;
+            m_gro = ::setsockopt(socket, SOL_UDP, UDP_GRO, &enable,
+                                 sizeof(enable)) == 0;
+        }
+
+        m_slot_size = m_gro ? gro_slot_size : max_buffer_size;
+        m_slots.resize(m_slot_size * batch_size);
+
+        for (std::size_t i = 0; i < batch_size; ++i)
+        {
+            m_iovecs[i].iov_base = m_slots.data() + i * m_slot_size;
+            m_iovecs[i].iov_len = m_slot_size;
+        }
+
+        m_buffers.reserve(m_gro ? m_slots.size() / max_buffer_size
+                                : batch_size);
+    }
+
+    /// @return true if generic receive offload is enabled
+    bool gro() const
+    {
+        return m_gro;
+    }
+
+    /// Wait for at least one datagram and receive all that are available,
+    /// up to the batch size. Buffers from the previous call are invalidated.
+    /// @return the number of buffers received, which is zero if only
+    ///         truncated datagrams were received
+    std::size_t receive(std::error_code& error)
+    {
+        m_buffers.clear();
+
+        for (std::size_t i = 0; i < m_messages.size(); ++i)
+        {
+            mmsghdr& message = m_messages[i];
+            std::memset(&message, 0, sizeof(message));
+            message.msg_hdr.msg_iov = &m_iovecs[i];
+            message.msg_hdr.msg_iovlen = 1;
+
+            if (m_gro)
+            {
+                message.msg_hdr.msg_control =
+                    m_controls.data() + i * CMSG_SPACE(sizeof(int));
+                message.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(int));
+            }
+        }
+
+        int result = -1;
+        do
+        {
+            result = ::recvmmsg(m_socket, m_messages.data(),
+                                (unsigned int)m_messages.size(),
+                                MSG_WAITFORONE, nullptr);
+            m_system_calls++;
+        } while (result < 0 && errno == EINTR);
+
+        if (result < 0)
+        {
+            error = std::error_code(errno, std::generic_category());
+            return 0;
+        }
+
+        for (int i = 0; i < result; ++i)
+        {
+            const mmsghdr& message = m_messages[i];
+            if (message.msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                m_truncated_buffers++;
+                continue;
+            }
+
+            const uint8_t* data = m_slots.data() + i * m_slot_size;
+            std::size_t size = message.msg_len;
+            std::size_t segment_size = size;
+
+            if (m_gro)
+            {
+                segment_size = gro_segment_size(message.msg_hdr, size);
+            }
+
+            for (std::size_t offset = 0; offset < size; offset += segment_size)
+            {
+                std::size_t length = std::min(segment_size, size - offset);
+                m_buffers.push_back(buffer{data + offset, length});
+            }
+        }
+
+        m_received_buffers += m_buffers.size();
+        return m_buffers.size();
+    }
+
+    /// @return the number of buffers from the last receive()
+    std::size_t buffers() const
+    {
+        return m_buffers.size();
+    }
+
+    /// @return the data of a received buffer
+    const uint8_t* buffer_data(std::size_t index) const
+    {
+        assert(index < m_buffers.size());
+        return m_buffers[index].m_data;
+    }
+
+    /// @return the size of a received buffer
+    std::size_t buffer_size(std::size_t index) const
+    {
+        assert(index < m_buffers.size());
+        return m_buffers[index].m_size;
+    }
+
+    /// @return the number of buffers received
+    uint64_t received_buffers() const
+    {
+        return m_received_buffers;
+    }
+
+    /// @return the number of datagrams dropped as larger than a buffer
+    uint64_t truncated_buffers() const
+    {
+        return m_truncated_buffers;
+    }
+
+    /// @return the number of receive system calls made
+    uint64_t system_calls() const
+    {
+        return m_system_calls;
+    }
+
+private:
+    /// A received buffer inside a slot
+    struct buffer
+    {
+        const uint8_t* m_data;
+        std::size_t m_size;
+    };
+
+    /// @return the size of the datagrams coalesced into a message
+    static std::size_t gro_segment_size(const msghdr& header, std::size_t size)
+    {
+        for (const cmsghdr* control = CMSG_FIRSTHDR(&header);
+             control != nullptr;
+             control = CMSG_NXTHDR(const_cast<msghdr*>(&header),
+                                   const_cast<cmsghdr*>(control)))
+        {
+            if (control->cmsg_level == SOL_UDP &&
+                control->cmsg_type == UDP_GRO)
+            {
+                int segment_size = 0;
+                std::memcpy(&segment_size, CMSG_DATA(control),
+                            sizeof(segment_size));
+                if (segment_size > 0)
+                {
+                    return (std::size_t)segment_size;
+                }
+            }
+        }
+
+        // Not coalesced
+        return size;
+    }
+
+private:
+    /// The socket
+    int m_socket;
+
+    /// True if generic receive offload is used
+    bool m_gro = false;
+
+    /// The size of each slot
+    std::size_t m_slot_size = 0;
+
+    /// The slots messages are received into
+    std::vector<uint8_t> m_slots;
+
+    /// The buffer of each message
+    std::vector<iovec> m_iovecs;
+
+    /// The messages passed to recvmmsg
+    std::vector<mmsghdr> m_messages;
+
+    /// Control data carrying the GRO segment size of each message
+    std::vector<uint8_t> m_controls;
+
+    /// The buffers from the last receive()
+    std::vector<buffer> m_buffers;
+
+    /// Statistics
+    uint64_t m_received_buffers = 0;
+    uint64_t m_truncated_buffers = 0;
+    uint64_t m_system_calls = 0;
+};
+} // namespace chunkie
@@ -0,0 +1,273 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace chunkie
+{
+/// Sends serialized buffers over a connected UDP socket in batches.
+///
+/// The serializer writes directly into the slots of the sender through
+/// prepare() and commit(). Queued buffers are sent with a single sendmmsg
+/// call per batch. With generic segmentation offload (GSO) enabled, runs of
+/// equally sized buffers are additionally handed to the kernel as a single
+/// message which is split into datagrams further down the stack.
+///
+/// Available on Linux.
+class udp_sender
+{
+public:
+    /// The maximum number of datagrams in a single GSO message
+    static const std::size_t max_gso_segments = 64;
+
+    /// The maximum payload of a single GSO message
+    static const std::size_t max_gso_size = 65000;
+
+public:
+    /// @param socket a connected UDP socket, not owned by the sender
+    /// @param max_buffer_size the maximum size of a buffer
+    /// @param batch_size the number of buffers sent per flush
+    udp_sender(int socket, std::size_t max_buffer_size,
+               std::size_t batch_size) :
+        m_socket(socket), m_max_buffer_size(max_buffer_size),
+        m_slots(max_buffer_size * batch_size), m_sizes(batch_size),
+        m_iovecs(batch_size), m_messages(batch_size),
+        m_controls(batch_size * CMSG_SPACE(sizeof(uint16_t)))
+    {
+        assert(socket >= 0 && "Invalid socket");
+        assert(max_buffer_size > 0 && "Buffers must have a size");
+        assert(batch_size > 0 && "Batch must hold buffers");
+    }
+
+    /// Enable or disable UDP generic segmentation offload. If the kernel
+    /// does not support it, it is disabled again on the first flush.
+    void set_gso(bool enabled)
+    {
+        m_gso = enabled;
+    }
+
+    /// @return true if generic segmentation offload is enabled
+    bool gso() const
+    {
+        return m_gso;
+    }
+
+    /// Reserve the next slot, flushing the batch first if it is full
+    /// @return pointer to max_buffer_size() bytes to write the buffer to, or
+    ///         nullptr on error
+    uint8_t* prepare(std::error_code& error)
+    {
+        if (m_queued == m_sizes.size())
+        {
+            flush(error);
+            if (error)
+            {
+                return nullptr;
+            }
+        }
+
+        return m_slots.data() + m_queued * m_max_buffer_size;
+    }
+
+    /// Queue the buffer written to the slot returned by prepare()
+    void commit(std::size_t size)
+    {
+        assert(m_queued < m_sizes.size() && "No slot prepared");
+        assert(size > 0 && size <= m_max_buffer_size && "Invalid size");
+
+        m_sizes[m_queued] = size;
+        m_queued++;
+    }
+
+    /// Send all queued buffers
+    void flush(std::error_code& error)
+    {
+        std::size_t sent = 0;
+
+        while (sent < m_queued)
+        {
+            std::size_t messages = build_messages(sent);
+
+            int result = ::sendmmsg(m_socket, m_messages.data(),
+                                    (unsigned int)messages, 0);
+            m_system_calls++;
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                if (m_gso && (errno == EIO || errno == EINVAL ||
+                              errno == EOPNOTSUPP || errno == ENOPROTOOPT))
+                {
+                    // No segmentation offload, retry with one datagram per
+                    // message
+                    m_gso = false;
+                    continue;
+                }
+
+                error = std::error_code(errno, std::generic_category());
+                m_queued = 0;
+                return;
+            }
+
+            for (int i = 0; i < result; ++i)
+            {
+                sent += m_messages[i].msg_hdr.msg_iovlen;
+            }
+        }
+
+        m_sent_buffers += m_queued;
+        m_queued = 0;
+    }
+
+    /// @return the maximum size of a buffer
+    std::size_t max_buffer_size() const
+    {
+        return m_max_buffer_size;
+    }
+
+    /// @return the number of buffers waiting to be sent
+    std::size_t queued_buffers() const
+    {
+        return m_queued;
+    }
+
+    /// @return the number of buffers sent
+    uint64_t sent_buffers() const
+    {
+        return m_sent_buffers;
+    }
+
+    /// @return the number of send system calls made
+    uint64_t system_calls() const
+    {
+        return m_system_calls;
+    }
+
+private:
+    /// Build the messages for the queued buffers starting at first
+    /// @return the number of messages
+    std::size_t build_messages(std::size_t first)
+    {
+        std::size_t messages = 0;
+        std::size_t index = first;
+
+        while (index < m_queued)
+        {
+            std::size_t segment_size = m_sizes[index];
+            std::size_t count = 1;
+
+            if (m_gso)
+            {
+                // All segments but the last must have the same size
+                std::size_t total = segment_size;
+                while (index + count < m_queued &&
+                       count < max_gso_segments &&
+                       m_sizes[index + count] <= segment_size &&
+                       total + m_sizes[index + count] <= max_gso_size)
+                {
+                    total += m_sizes[index + count];
+                    count++;
+
+                    if (m_sizes[index + count - 1] < segment_size)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                m_iovecs[index + i].iov_base =
+                    m_slots.data() + (index + i) * m_max_buffer_size;
+                m_iovecs[index + i].iov_len = m_sizes[index + i];
+            }
+
+            mmsghdr& message = m_messages[messages];
+            std::memset(&message, 0, sizeof(message));
+            message.msg_hdr.msg_iov = &m_iovecs[index];
+            message.msg_hdr.msg_iovlen = count;
+
+            if (count > 1)
+            {
+                uint8_t* control =
+                    m_controls.data() + messages * CMSG_SPACE(sizeof(uint16_t));
+                std::memset(control, 0, CMSG_SPACE(sizeof(uint16_t)));
+
+                message.msg_hdr.msg_control = control;
+                message.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+                cmsghdr* header = CMSG_FIRSTHDR(&message.msg_hdr);
+                header->cmsg_level = SOL_UDP;
+                header->cmsg_type = UDP_SEGMENT;
+                header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                uint16_t size = (uint16_t)segment_size;
+                std::memcpy(CMSG_DATA(header), &size, sizeof(size));
+            }
+
+            messages++;
+            index += count;
+        }
+
+        return messages;
+    }
+
+private:
+    /// The socket
+    int m_socket;
+
+    /// The size of each slot
+    std::size_t m_max_buffer_size;
+
+    /// The slots the buffers are written to
+    std::vector<uint8_t> m_slots;
+
+    /// The size of the buffer in each slot
+    std::vector<std::size_t> m_sizes;
+
+    /// The buffers of the messages
+    std::vector<iovec> m_iovecs;
+
+    /// The messages passed to sendmmsg
+    std::vector<mmsghdr> m_messages;
+
+    /// Control data carrying the GSO segment size of each message
+    std::vector<uint8_t> m_controls;
+
+    /// The number of queued buffers
+    std::size_t m_queued = 0;
+
+    /// True if generic segmentation offload is used
+    bool m_gso = false;
+
+    /// Statistics
+    uint64_t m_sent_buffers = 0;
+    uint64_t m_system_calls = 0;
+};
+} // namespace chunkie
@@ -0,0 +1,42 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+// Start header extension carrying a two byte tag, shared by the tests of the
+// serializer, the deserializer and the archive
+struct tag_extension
+{
+    static const std::size_t size = 2;
+
+    void write(uint8_t* data) const
+    {
+        data[0] = (uint8_t)(m_tag >> 8);
+        data[1] = (uint8_t)m_tag;
+    }
+
+    void read(const uint8_t* data)
+    {
+        m_tag = (uint16_t)((data[0] << 8) | data[1]);
+    }
+
+    void on_set_object()
+    {
+    }
+
+    void on_object_completed()
+    {
+    }
+
+    uint16_t m_tag = 0;
+};
+
+const std::size_t tag_extension::size;
+}
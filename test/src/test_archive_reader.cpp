@@ -0,0 +1,267 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/archive_reader.hpp>
+#include <chunkie/archive_writer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include "tag_extension.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+// Write the objects packed back to back into buffers of 1400 bytes
+void write_archive(const std::string& path,
+                   const std::vector<std::vector<uint8_t>>& objects)
+{
+    const uint32_t max_buffer_size = 1400;
+
+    chunkie::serializer<uint32_t> serializer;
+    chunkie::archive_writer<uint32_t> writer;
+    std::error_code error;
+    writer.open(path, 64 * 1024, error);
+    ASSERT_FALSE(error);
+
+    std::vector<uint8_t> buffer(max_buffer_size);
+    std::size_t used = 0;
+
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+        while (!serializer.object_proccessed())
+        {
+            if (max_buffer_size - used <= 4)
+            {
+                writer.write(buffer.data(), used, error);
+                used = 0;
+            }
+
+            auto size =
+                std::min<uint32_t>((uint32_t)(max_buffer_size - used),
+                                   serializer.max_write_buffer_size());
+            serializer.write_buffer(buffer.data() + used, size);
+            used += size;
+        }
+    }
+    writer.write(buffer.data(), used, error);
+
+    EXPECT_EQ(objects.size(), writer.objects());
+    writer.close(error);
+    ASSERT_FALSE(error);
+}
+}
+
+// Read the objects of an archive in random order
+TEST(test_archive_reader, random_access)
+{
+    const std::string path = "test_archive_reader_random_access.bin";
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 5000), (uint8_t)rand());
+    }
+
+    write_archive(path, objects);
+
+    chunkie::archive_reader<uint32_t> reader;
+    std::error_code error;
+    reader.open(path, 16 * 1024, error);
+    ASSERT_FALSE(error);
+    ASSERT_EQ(objects.size(), reader.objects());
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        auto index = rand() % objects.size();
+        ASSERT_EQ(objects[index].size(), reader.object_size(index));
+
+        std::vector<uint8_t> object(reader.object_size(index));
+        ASSERT_TRUE(reader.read_object(index, object.data(), error));
+        EXPECT_EQ(objects[index], object);
+    }
+
+    EXPECT_FALSE(error);
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+// The index of an interrupted recording is recovered
+TEST(test_archive_reader, recover_index)
+{
+    const std::string path = "test_archive_reader_recover.bin";
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < 600; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 1000), (uint8_t)rand());
+    }
+
+    write_archive(path, objects);
+
+    // Cut the file in the last index block, losing the trailer
+    struct stat status;
+    ASSERT_EQ(0, ::stat(path.c_str(), &status));
+    ASSERT_EQ(0, ::truncate(path.c_str(), status.st_size - 100));
+
+    chunkie::archive_reader<uint32_t> reader;
+    std::error_code error;
+    reader.open(path, 16 * 1024, error);
+    ASSERT_FALSE(error);
+    ASSERT_EQ(objects.size(), reader.objects());
+
+    for (std::size_t index = 0; index < objects.size(); ++index)
+    {
+        ASSERT_EQ(objects[index].size(), reader.object_size(index));
+
+        std::vector<uint8_t> object(reader.object_size(index));
+        ASSERT_TRUE(reader.read_object(index, object.data(), error));
+        EXPECT_EQ(objects[index], object);
+    }
+
+    reader.close();
+    std::remove(path.c_str());
+}
+
+// Objects are located and read past their start header extensions
+TEST(test_archive_reader, extension)
+{
+    const std::string path = "test_archive_reader_extension.bin";
+
+    std::vector<std::vector<uint8_t>> objects = {
+        std::vector<uint8_t>(10, 1), std::vector<uint8_t>(30, 2),
+        std::vector<uint8_t>(5, 3)};
+
+    {
+        chunkie::serializer<uint16_t, tag_extension> serializer;
+        chunkie::archive_writer<uint16_t, tag_extension> writer;
+        std::error_code error;
+        writer.open(path, 1024, error);
+        ASSERT_FALSE(error);
+
+        std::vector<uint8_t> buffer(20);
+        std::size_t used = 0;
+
+        for (const auto& object : objects)
+        {
+            serializer.set_object(object.data(), (uint16_t)object.size());
+            while (!serializer.object_proccessed())
+            {
+                if (buffer.size() - used <= 4)
+                {
+                    writer.write(buffer.data(), used, error);
+                    used = 0;
+                }
+
+                auto size = std::min<uint16_t>(
+                    (uint16_t)(buffer.size() - used),
+                    serializer.max_write_buffer_size());
+                serializer.write_buffer(buffer.data() + used, size);
+                used += size;
+            }
+        }
+        writer.write(buffer.data(), used, error);
+
+        EXPECT_EQ(objects.size(), writer.objects());
+        writer.close(error);
+        ASSERT_FALSE(error);
+    }
+
+    chunkie::archive_reader<uint16_t, tag_extension> reader;
+    std::error_code error;
+    reader.open(path, 1024, error);
+    ASSERT_FALSE(error);
+    ASSERT_EQ(objects.size(), reader.objects());
+
+    for (std::size_t i = objects.size(); i-- > 0;)
+    {
+        ASSERT_EQ(objects[i].size(), reader.object_size(i));
+        std::vector<uint8_t> object(reader.object_size(i));
+        ASSERT_TRUE(reader.read_object(i, object.data(), error));
+        EXPECT_EQ(objects[i], object);
+    }
+
+    reader.close();
+    std::remove(path.c_str());
+}
+
+// An object cut short at the end of the records is not read into the index
+TEST(test_archive_reader, truncated_object)
+{
+    const std::string path = "test_archive_reader_truncated.bin";
+
+    {
+        chunkie::archive_writer<uint8_t> writer;
+        std::error_code error;
+        writer.open(path, 100, error);
+        ASSERT_FALSE(error);
+
+        // An object of 3 bytes, then one of 100 bytes of which the rest
+        // was never recorded
+        std::vector<uint8_t> buffer = {0b10000000 | 3, 1, 2, 3,
+                                       0b10000000 | 100, 4, 5};
+        writer.write(buffer.data(), buffer.size(), error);
+        writer.close(error);
+        ASSERT_FALSE(error);
+    }
+
+    chunkie::archive_reader<uint8_t> reader;
+    std::error_code error;
+    reader.open(path, 100, error);
+    ASSERT_FALSE(error);
+    ASSERT_EQ(2U, reader.objects());
+
+    std::vector<uint8_t> object(reader.object_size(1));
+    EXPECT_FALSE(reader.read_object(1, object.data(), error));
+    EXPECT_EQ(chunkie::error::invalid_archive, error);
+
+    // The complete object is still read
+    error = std::error_code();
+    object.resize(reader.object_size(0));
+    EXPECT_TRUE(reader.read_object(0, object.data(), error));
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3}), object);
+
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST(test_archive_reader, invalid_archive)
+{
+    const std::string path = "test_archive_reader_invalid.bin";
+
+    {
+        // A trailer pointing to an index block which is not there
+        std::vector<uint8_t> content(100, 0);
+        std::vector<uint8_t> trailer = {0,   0,   0,   24,  0,   0,   0,
+                                        0,   0,   0,   0,   0,   0,   0,
+                                        0,   0,   0,   0,   0,   1,   'C',
+                                        'H', 'U', 'N', 'K', 'I', 'D', 'X'};
+        content.insert(content.end(), trailer.begin(), trailer.end());
+
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char*)content.data(), content.size());
+    }
+
+    chunkie::archive_reader<uint32_t> reader;
+    std::error_code error;
+    reader.open(path, 1000, error);
+    EXPECT_EQ(chunkie::error::invalid_archive, error);
+    EXPECT_FALSE(reader.is_open());
+
+    std::remove(path.c_str());
+}
+
+#endif
@@ -0,0 +1,61 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/archive_writer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+TEST(test_archive_writer, index)
+{
+    const std::string path = "test_archive_writer_index.bin";
+
+    chunkie::archive_writer<uint8_t> writer;
+    std::error_code error;
+    writer.open(path, 100, error);
+    ASSERT_FALSE(error);
+
+    // An object spanning two buffers followed by one starting in the second
+    std::vector<uint8_t> first = {0b10000000 | 3, 1, 2};
+    std::vector<uint8_t> second = {1, 3, 0b10000000 | 2, 4, 5};
+
+    writer.write(first.data(), first.size(), error);
+    writer.write(second.data(), second.size(), error);
+    EXPECT_EQ(2U, writer.objects());
+
+    writer.close(error);
+    ASSERT_FALSE(error);
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+
+    std::vector<uint8_t> expected = {
+        // records
+        0, 0, 0, 3, 0b10000000 | 3, 1, 2, 0, 0, 0, 5, 1, 3, 0b10000000 | 2, 4,
+        5,
+        // index block record, without a previous block
+        0, 0, 0, 60, 'C', 'H', 'U', 'N', 'K', 'B', 'L', 'K', 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 2,
+        // entry of the first object
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3,
+        // entry of the second object
+        0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2,
+        // trailer record with the last block, object count and magic
+        0, 0, 0, 24, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 2, 'C', 'H',
+        'U', 'N', 'K', 'I', 'D', 'X'};
+
+    EXPECT_EQ(expected, content);
+
+    std::remove(path.c_str());
+}
+
+#endif
@@ -0,0 +1,150 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/buffer_pool.hpp>
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(test_buffer_pool, basic)
+{
+    chunkie::buffer_pool pool(100, 4);
+    EXPECT_EQ(100U, pool.buffer_size());
+    EXPECT_EQ(4U, pool.buffer_count());
+    EXPECT_EQ(64U, chunkie::buffer_pool::alignment);
+
+    std::set<uint8_t*> buffers;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        auto buffer = pool.acquire();
+        ASSERT_NE(nullptr, buffer);
+        EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(buffer) %
+                          chunkie::buffer_pool::alignment);
+        buffers.insert(buffer);
+    }
+
+    EXPECT_EQ(4U, buffers.size());
+    EXPECT_EQ(nullptr, pool.acquire());
+
+    pool.release(*buffers.begin());
+    EXPECT_EQ(*buffers.begin(), pool.acquire());
+    EXPECT_EQ(nullptr, pool.acquire());
+}
+
+TEST(test_buffer_pool, huge_pages)
+{
+    // Huge pages may not be available, in which case regular pages are used
+    chunkie::buffer_pool pool(1500, 16, true);
+
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        auto buffer = pool.acquire();
+        ASSERT_NE(nullptr, buffer);
+        std::fill_n(buffer, pool.buffer_size(), (uint8_t)i);
+    }
+}
+
+TEST(test_buffer_pool, release_from_threads)
+{
+    chunkie::buffer_pool pool(64, 32);
+
+    std::vector<uint8_t*> buffers;
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        buffers.push_back(pool.acquire());
+    }
+
+    std::vector<std::thread> transports;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        transports.emplace_back(
+            [&pool, &buffers, i]()
+            {
+                for (uint32_t j = i; j < buffers.size(); j += 4)
+                {
+                    pool.release(buffers[j]);
+                }
+            });
+    }
+
+    for (auto& transport : transports)
+    {
+        transport.join();
+    }
+
+    std::set<uint8_t*> acquired;
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        auto buffer = pool.acquire();
+        ASSERT_NE(nullptr, buffer);
+        acquired.insert(buffer);
+    }
+
+    EXPECT_EQ(std::set<uint8_t*>(buffers.begin(), buffers.end()), acquired);
+    EXPECT_EQ(nullptr, pool.acquire());
+}
+
+// The serializer writes directly into buffers from the pool
+TEST(test_buffer_pool, serializer)
+{
+    chunkie::buffer_pool pool(100, 2);
+    chunkie::serializer<uint32_t> serializer;
+    chunkie::deserializer<uint32_t> deserializer;
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        std::vector<uint8_t> object(1 + (rand() % 1000), (uint8_t)i);
+        std::vector<uint8_t> output;
+
+        serializer.set_object(object.data(), (uint32_t)object.size());
+
+        while (!serializer.object_proccessed())
+        {
+            uint32_t size = 0;
+            auto buffer = serializer.write_pooled_buffer(pool, size);
+            ASSERT_NE(nullptr, buffer);
+
+            deserializer.set_buffer(buffer, size);
+            while (!deserializer.buffer_proccessed())
+            {
+                output.resize(deserializer.object_size());
+                deserializer.write_to_object(output.data());
+            }
+
+            pool.release(buffer);
+        }
+
+        EXPECT_TRUE(deserializer.object_completed());
+        EXPECT_EQ(object, output);
+    }
+}
+
+// Nothing is written when the pool has no free buffer
+TEST(test_buffer_pool, serializer_pool_empty)
+{
+    chunkie::buffer_pool pool(100, 1);
+    chunkie::serializer<uint32_t> serializer;
+
+    std::vector<uint8_t> object(500, 1);
+    serializer.set_object(object.data(), (uint32_t)object.size());
+
+    uint32_t size = 0;
+    auto buffer = serializer.write_pooled_buffer(pool, size);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(100U, size);
+    auto remaining = serializer.max_write_buffer_size();
+
+    EXPECT_EQ(nullptr, serializer.write_pooled_buffer(pool, size));
+    EXPECT_EQ(remaining, serializer.max_write_buffer_size());
+
+    pool.release(buffer);
+    EXPECT_EQ(buffer, serializer.write_pooled_buffer(pool, size));
+}
@@ -0,0 +1,39 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/buffer_range.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <vector>
+
+TEST(test_buffer_range, buffers)
+{
+    chunkie::serializer<uint8_t> serializer;
+
+    std::vector<uint8_t> object = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    serializer.set_object(object.data(), (uint8_t)object.size());
+
+    std::vector<uint8_t> storage(4);
+    std::vector<std::vector<uint8_t>> buffers;
+
+    for (auto buffer :
+         chunkie::make_buffer_range(serializer, storage.data(), 4))
+    {
+        EXPECT_EQ(storage.data(), buffer.m_data);
+        buffers.emplace_back(buffer.m_data, buffer.m_data + buffer.m_size);
+    }
+
+    std::vector<std::vector<uint8_t>> expected_buffers = {
+        {0b10000000 | 9, 0, 1, 2}, {6, 3, 4, 5}, {3, 6, 7, 8}};
+
+    EXPECT_EQ(expected_buffers, buffers);
+    EXPECT_TRUE(serializer.object_proccessed());
+
+    // The range of a processed object is empty
+    auto range = chunkie::make_buffer_range(serializer, storage.data(), 4);
+    EXPECT_TRUE(range.begin() == range.end());
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/chunk_file_reader.hpp>
+#include <chunkie/chunk_file_writer.hpp>
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// Record a serialized stream and replay it through the deserializer
+TEST(test_chunk_file_reader, replay)
+{
+    const std::string path = "test_chunk_file_reader_replay.bin";
+    const uint32_t max_buffer_size = 1400;
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 5000), (uint8_t)rand());
+    }
+
+    {
+        chunkie::serializer<uint32_t> serializer;
+        chunkie::chunk_file_writer writer;
+        std::error_code error;
+        writer.open(path, 64 * 1024, error);
+        ASSERT_FALSE(error);
+
+        for (const auto& object : objects)
+        {
+            serializer.set_object(object.data(), (uint32_t)object.size());
+            while (!serializer.object_proccessed())
+            {
+                auto size = std::min<uint32_t>(
+                    max_buffer_size, serializer.max_write_buffer_size());
+
+                uint8_t* buffer = writer.prepare(size, error);
+                ASSERT_NE(nullptr, buffer);
+                serializer.write_buffer(buffer, size);
+                writer.commit(size);
+            }
+        }
+
+        writer.close(error);
+        ASSERT_FALSE(error);
+    }
+
+    chunkie::deserializer<uint32_t> deserializer;
+    chunkie::chunk_file_reader reader;
+    std::error_code error;
+    reader.open(path, 4096, error);
+    ASSERT_FALSE(error);
+
+    std::vector<std::vector<uint8_t>> restored;
+    std::vector<uint8_t> object;
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+    while (reader.read_buffer(data, size, error))
+    {
+        deserializer.set_buffer(data, (uint32_t)size);
+        while (!deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                restored.push_back(object);
+            }
+        }
+    }
+
+    EXPECT_FALSE(error);
+    EXPECT_EQ(objects, restored);
+
+    // Reading past the end keeps reporting the end of the file
+    EXPECT_FALSE(reader.read_buffer(data, size, error));
+    EXPECT_FALSE(error);
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(test_chunk_file_reader, empty_file)
+{
+    const std::string path = "test_chunk_file_reader_empty.bin";
+    std::ofstream(path, std::ios::binary).close();
+
+    chunkie::chunk_file_reader reader;
+    std::error_code error;
+    reader.open(path, 100, error);
+    ASSERT_FALSE(error);
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+    EXPECT_FALSE(reader.read_buffer(data, size, error));
+    EXPECT_FALSE(error);
+
+    std::remove(path.c_str());
+}
+
+TEST(test_chunk_file_reader, corrupt_file)
+{
+    const std::string path = "test_chunk_file_reader_corrupt.bin";
+
+    {
+        // A complete record followed by a truncated one
+        std::vector<uint8_t> content = {0, 0, 0, 2, 1, 2, 0, 0, 0, 9, 1};
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char*)content.data(), content.size());
+    }
+
+    chunkie::chunk_file_reader reader;
+    std::error_code error;
+
+    reader.open(path, 100, error);
+    ASSERT_FALSE(error);
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+    EXPECT_TRUE(reader.read_buffer(data, size, error));
+    EXPECT_EQ(2U, size);
+    EXPECT_EQ(2U, data[1]);
+
+    EXPECT_FALSE(reader.read_buffer(data, size, error));
+    EXPECT_EQ(chunkie::error::truncated_record, error);
+    reader.close();
+
+    // The batch cannot hold the first record
+    error = std::error_code();
+    reader.open(path, 5, error);
+    ASSERT_FALSE(error);
+    EXPECT_FALSE(reader.read_buffer(data, size, error));
+    EXPECT_EQ(chunkie::error::record_too_large, error);
+
+    std::remove(path.c_str());
+}
+
+TEST(test_chunk_file_reader, seek)
+{
+    const std::string path = "test_chunk_file_reader_seek.bin";
+
+    std::vector<uint64_t> offsets;
+    {
+        chunkie::chunk_file_writer writer;
+        std::error_code error;
+        writer.open(path, 1000, error);
+        ASSERT_FALSE(error);
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            offsets.push_back(writer.offset());
+            std::vector<uint8_t> buffer(1 + (i % 50), (uint8_t)i);
+            writer.write(buffer.data(), buffer.size(), error);
+        }
+
+        writer.close(error);
+        ASSERT_FALSE(error);
+    }
+
+    chunkie::chunk_file_reader reader;
+    std::error_code error;
+    reader.open(path, 200, error);
+    ASSERT_FALSE(error);
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    for (uint32_t i : {70U, 3U, 99U, 0U, 42U})
+    {
+        reader.seek(offsets[i]);
+
+        ASSERT_TRUE(reader.read_buffer(data, size, error));
+        EXPECT_EQ(1U + (i % 50), size);
+        EXPECT_EQ(i, data[0]);
+
+        // Reading continues with the following records
+        if (i + 1 < offsets.size())
+        {
+            ASSERT_TRUE(reader.read_buffer(data, size, error));
+            EXPECT_EQ(i + 1, data[0]);
+        }
+    }
+
+    EXPECT_FALSE(error);
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+#endif
@@ -0,0 +1,117 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/chunk_file_writer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file),
+                                std::istreambuf_iterator<char>());
+}
+}
+
+TEST(test_chunk_file_writer, basic)
+{
+    const std::string path = "test_chunk_file_writer_basic.bin";
+
+    chunkie::chunk_file_writer writer;
+    std::error_code error;
+    writer.open(path, 16, error);
+    ASSERT_FALSE(error);
+    EXPECT_TRUE(writer.is_open());
+    EXPECT_EQ(0U, writer.offset());
+
+    std::vector<uint8_t> buffer = {1, 2, 3};
+    writer.write(buffer.data(), buffer.size(), error);
+    ASSERT_FALSE(error);
+    EXPECT_EQ(7U, writer.offset());
+
+    // Write directly into the batch, using less than prepared
+    uint8_t* data = writer.prepare(10, error);
+    ASSERT_FALSE(error);
+    ASSERT_NE(nullptr, data);
+    data[0] = 4;
+    data[1] = 5;
+    writer.commit(2);
+    EXPECT_EQ(13U, writer.offset());
+
+    // Does not fit in the current batch
+    data = writer.prepare(5, error);
+    ASSERT_NE(nullptr, data);
+    std::fill_n(data, 5, 6);
+    writer.commit(5);
+    EXPECT_EQ(22U, writer.offset());
+
+    writer.close(error);
+    ASSERT_FALSE(error);
+    EXPECT_FALSE(writer.is_open());
+
+    std::vector<uint8_t> expected = {0, 0, 0, 3, 1, 2, 3, 0, 0, 0, 2,
+                                     4, 5, 0, 0, 0, 5, 6, 6, 6, 6, 6};
+    EXPECT_EQ(expected, read_file(path));
+
+    std::remove(path.c_str());
+}
+
+TEST(test_chunk_file_writer, many_batches)
+{
+    const std::string path = "test_chunk_file_writer_many_batches.bin";
+
+    chunkie::chunk_file_writer writer;
+    std::error_code error;
+    writer.open(path, 1000, error);
+    ASSERT_FALSE(error);
+
+    std::vector<uint8_t> expected;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        std::vector<uint8_t> buffer(1 + (rand() % 200), (uint8_t)i);
+        writer.write(buffer.data(), buffer.size(), error);
+        ASSERT_FALSE(error);
+
+        expected.push_back(0);
+        expected.push_back(0);
+        expected.push_back(0);
+        expected.push_back((uint8_t)buffer.size());
+        expected.insert(expected.end(), buffer.begin(), buffer.end());
+
+        if (i % 100 == 0)
+        {
+            writer.flush(error);
+            ASSERT_FALSE(error);
+        }
+    }
+
+    EXPECT_EQ(expected.size(), writer.offset());
+    writer.close(error);
+    ASSERT_FALSE(error);
+
+    EXPECT_EQ(expected, read_file(path));
+
+    std::remove(path.c_str());
+}
+
+TEST(test_chunk_file_writer, open_error)
+{
+    chunkie::chunk_file_writer writer;
+    std::error_code error;
+    writer.open("no_such_directory/file.bin", 100, error);
+    EXPECT_TRUE((bool)error);
+    EXPECT_FALSE(writer.is_open());
+}
+
+#endif
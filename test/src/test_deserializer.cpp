@@ -7,6 +7,8 @@
 
 #include <chunkie/deserializer.hpp>
 
+#include "tag_extension.hpp"
+
 #include <vector>
 
 TEST(test_deserializer, basic)
@@ -357,3 +359,96 @@ TEST(test_deserializer, lost_buffers_and_zero_padding)
     EXPECT_TRUE(deserializer.buffer_proccessed());
     EXPECT_EQ(expected_object, objects);
 }
+
+// The extension is read after every start header
+TEST(test_deserializer, start_header_extension)
+{
+    using deserializer_type = chunkie::deserializer<uint8_t, tag_extension>;
+    deserializer_type deserializer;
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0b10000000 | 5, 1, 2, 1, 2},
+        {3, 3, 4, 5, 0b10000000 | 2, 0, 7, 6, 7}};
+
+    std::vector<std::vector<uint8_t>> expected_objects = {{1, 2, 3, 4, 5},
+                                                          {6, 7}};
+    std::vector<uint16_t> expected_tags = {0x0102, 0x0007};
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<uint16_t> tags;
+    std::vector<uint8_t> object;
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.set_buffer(buffer.data(), (uint8_t)buffer.size());
+
+        while (!deserializer.buffer_proccessed())
+        {
+            auto tag = deserializer.extension().m_tag;
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+
+            if (deserializer.object_completed())
+            {
+                objects.push_back(object);
+                tags.push_back(tag);
+            }
+        }
+    }
+
+    EXPECT_EQ(expected_objects, objects);
+    EXPECT_EQ(expected_tags, tags);
+}
+
+// Malformed buffers are reported and dropped by the validating set_buffer
+TEST(test_deserializer, malformed_buffers)
+{
+    using deserializer_type = chunkie::deserializer<uint8_t, tag_extension>;
+    deserializer_type deserializer;
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        // smaller than a header
+        {0b10000000},
+        // an empty object
+        {0b10000000, 0, 0},
+        // an object followed by a truncated extension
+        {0b10000000 | 2, 0, 7, 6, 7, 0b10000000 | 3, 0},
+        // the continuation of an object never started
+        {2, 3, 4},
+        // a valid object
+        {0b10000000 | 2, 0, 8, 8, 9}};
+
+    std::vector<bool> expected_errors = {true, true, true, false, false};
+    std::vector<std::vector<uint8_t>> expected_objects = {{6, 7}, {8, 9}};
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<bool> errors;
+    std::vector<uint8_t> object;
+
+    for (const auto& buffer : buffers)
+    {
+        std::error_code error;
+        deserializer.set_buffer(buffer.data(), (uint8_t)buffer.size(), error);
+
+        while (!error && !deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data(), error);
+
+            if (deserializer.object_completed())
+            {
+                objects.push_back(object);
+            }
+        }
+
+        EXPECT_TRUE(deserializer.buffer_proccessed());
+        if (error)
+        {
+            EXPECT_EQ(chunkie::error::invalid_buffer, error);
+        }
+        errors.push_back((bool)error);
+    }
+
+    EXPECT_EQ(expected_errors, errors);
+    EXPECT_EQ(expected_objects, objects);
+}
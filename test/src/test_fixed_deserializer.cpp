@@ -0,0 +1,108 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/fixed_deserializer.hpp>
+#include <chunkie/fixed_serializer.hpp>
+
+#include <vector>
+
+TEST(test_fixed_deserializer, read)
+{
+    chunkie::fixed_deserializer<3> deserializer;
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0, 0, 1, 2, 3}, {1, 4, 5, 6, 7}, {2, 8, 9, 10, 11}};
+
+    std::vector<std::vector<uint8_t>> expected_objects = {
+        {0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {9, 10, 11}};
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<uint8_t> object(3);
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.set_buffer(buffer.data(), buffer.size());
+        while (!deserializer.buffer_proccessed())
+        {
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                objects.push_back(object);
+            }
+        }
+    }
+
+    EXPECT_EQ(expected_objects, objects);
+}
+
+// The objects spanning a lost buffer are dropped
+TEST(test_fixed_deserializer, lost_buffer)
+{
+    chunkie::fixed_deserializer<3> deserializer;
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0, 0, 1, 2, 3}, {2, 8, 9, 10, 11}, {1, 13, 14, 15, 16, 17}};
+
+    std::vector<std::vector<uint8_t>> expected_objects = {
+        {0, 1, 2}, {9, 10, 11}, {15, 16, 17}};
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<uint8_t> object(3);
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.set_buffer(buffer.data(), buffer.size());
+        while (!deserializer.buffer_proccessed())
+        {
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                objects.push_back(object);
+            }
+        }
+    }
+
+    EXPECT_EQ(expected_objects, objects);
+}
+
+TEST(test_fixed_deserializer, serialize_deserialize)
+{
+    chunkie::fixed_serializer<100, true> serializer;
+    chunkie::fixed_deserializer<100, true> deserializer;
+
+    std::vector<uint8_t> buffer(300);
+    std::vector<uint8_t> input(100);
+    std::vector<uint8_t> output(100);
+    uint32_t completed = 0;
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            serializer.set_buffer(buffer.data(), buffer.size());
+        }
+
+        input.assign(100, (uint8_t)i);
+        serializer.set_object(input.data());
+        serializer.write();
+
+        if (serializer.buffer_remaining() == 0 || i == 9)
+        {
+            deserializer.set_buffer(buffer.data(), serializer.buffer_size());
+            while (!deserializer.buffer_proccessed())
+            {
+                deserializer.write_to_object(output.data());
+                EXPECT_TRUE(deserializer.object_completed());
+                EXPECT_EQ(std::vector<uint8_t>(100, (uint8_t)completed),
+                          output);
+                completed++;
+            }
+        }
+    }
+
+    EXPECT_EQ(10U, completed);
+}
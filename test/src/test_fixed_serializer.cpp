@@ -0,0 +1,76 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/fixed_serializer.hpp>
+
+#include <type_traits>
+#include <vector>
+
+TEST(test_fixed_serializer, header_type)
+{
+    EXPECT_TRUE((std::is_same<uint8_t, chunkie::fixed_offset<1>>::value));
+    EXPECT_TRUE((std::is_same<uint8_t, chunkie::fixed_offset<256>>::value));
+    EXPECT_TRUE((std::is_same<uint16_t, chunkie::fixed_offset<257>>::value));
+    EXPECT_TRUE(
+        (std::is_same<uint32_t, chunkie::fixed_offset<0x10001>>::value));
+
+    EXPECT_EQ(1U, (chunkie::fixed_serializer<3>::header_size));
+    EXPECT_EQ(0U, (chunkie::fixed_serializer<3, true>::header_size));
+}
+
+TEST(test_fixed_serializer, write)
+{
+    chunkie::fixed_serializer<3> serializer;
+
+    std::vector<std::vector<uint8_t>> objects = {
+        {0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {9, 10, 11}};
+
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<uint8_t> buffer(5);
+
+    serializer.set_buffer(buffer.data(), buffer.size());
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data());
+        while (!serializer.object_proccessed())
+        {
+            serializer.write();
+            if (serializer.buffer_remaining() == 0)
+            {
+                buffers.push_back(buffer);
+                serializer.set_buffer(buffer.data(), buffer.size());
+            }
+        }
+    }
+    buffers.emplace_back(buffer.begin(),
+                         buffer.begin() + serializer.buffer_size());
+
+    // The header is the offset of the first byte within its object
+    std::vector<std::vector<uint8_t>> expected_buffers = {
+        {0, 0, 1, 2, 3}, {1, 4, 5, 6, 7}, {2, 8, 9, 10, 11}, {0}};
+
+    EXPECT_EQ(expected_buffers, buffers);
+}
+
+TEST(test_fixed_serializer, aligned)
+{
+    chunkie::fixed_serializer<2, true> serializer;
+
+    std::vector<uint8_t> first = {1, 2};
+    std::vector<uint8_t> second = {3, 4};
+    std::vector<uint8_t> buffer(4);
+
+    serializer.set_buffer(buffer.data(), buffer.size());
+    serializer.set_object(first.data());
+    serializer.write();
+    serializer.set_object(second.data());
+    serializer.write();
+
+    EXPECT_TRUE(serializer.object_proccessed());
+    EXPECT_EQ(4U, serializer.buffer_size());
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4}), buffer);
+}
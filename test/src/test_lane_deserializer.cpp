@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/lane_deserializer.hpp>
+#include <chunkie/priority_serializer.hpp>
+
+#include <vector>
+
+TEST(test_lane_deserializer, interleaved_lanes)
+{
+    chunkie::lane_deserializer<uint8_t> deserializer(2);
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {1, 0b10000000 | 8, 1, 2, 3, 4},
+        {0, 0b10000000 | 2, 9, 9},
+        {7, 0b10000000 | 1, 1},
+        {1, 4, 5, 6, 7, 8}};
+
+    std::vector<std::vector<uint8_t>> objects(2);
+    std::vector<std::vector<uint8_t>> completed;
+    std::vector<uint32_t> lanes;
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.set_buffer(buffer.data(), (uint8_t)buffer.size());
+        while (!deserializer.buffer_proccessed())
+        {
+            auto lane = deserializer.lane();
+            objects[lane].resize(deserializer.object_size());
+            deserializer.write_to_object(objects[lane].data());
+
+            if (deserializer.object_completed())
+            {
+                completed.push_back(objects[lane]);
+                lanes.push_back(lane);
+            }
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> expected = {{9, 9},
+                                                  {1, 2, 3, 4, 5, 6, 7, 8}};
+    EXPECT_EQ(expected, completed);
+    EXPECT_EQ(std::vector<uint32_t>({0, 1}), lanes);
+}
+
+// Urgent objects are delivered within one buffer of being queued, while a
+// large object is in progress
+TEST(test_lane_deserializer, preemption)
+{
+    chunkie::priority_serializer<uint32_t> serializer(2);
+    chunkie::lane_deserializer<uint32_t> deserializer(2);
+
+    std::vector<uint8_t> bulk(1000000, 'b');
+    std::vector<uint8_t> urgent(50, 'u');
+    serializer.push_object(1, bulk.data(), (uint32_t)bulk.size());
+
+    std::vector<std::vector<uint8_t>> objects(2);
+    std::vector<uint8_t> buffer(1400);
+    uint32_t urgent_received = 0;
+    uint32_t bulk_received = 0;
+
+    for (uint32_t i = 0; serializer.has_objects(); ++i)
+    {
+        if (i % 100 == 10)
+        {
+            serializer.push_object(0, urgent.data(), (uint32_t)urgent.size());
+        }
+
+        auto size = serializer.write_buffer(buffer.data(), 1400);
+        deserializer.set_buffer(buffer.data(), size);
+
+        while (!deserializer.buffer_proccessed())
+        {
+            auto lane = deserializer.lane();
+            objects[lane].resize(deserializer.object_size());
+            deserializer.write_to_object(objects[lane].data());
+
+            if (deserializer.object_completed() && lane == 0)
+            {
+                EXPECT_EQ(urgent, objects[0]);
+                urgent_received++;
+                // The urgent object was written right after being queued
+                EXPECT_EQ(10U, i % 100);
+            }
+            else if (deserializer.object_completed())
+            {
+                EXPECT_EQ(bulk, objects[1]);
+                bulk_received++;
+            }
+        }
+    }
+
+    EXPECT_LT(0U, urgent_received);
+    EXPECT_EQ(serializer.completed_objects(0), urgent_received);
+    EXPECT_EQ(1U, bulk_received);
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/latency_histogram.hpp>
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+TEST(test_latency_histogram, percentile)
+{
+    chunkie::latency_histogram histogram;
+    EXPECT_EQ(0U, histogram.count());
+    EXPECT_EQ(0U, histogram.percentile(50));
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        histogram.record(i * 1000);
+    }
+
+    EXPECT_EQ(1000U, histogram.count());
+    EXPECT_EQ(1000000U, histogram.max());
+
+    // Values are reported within the precision of the histogram
+    std::vector<double> percentiles = {1, 50, 90, 99, 100};
+    for (auto percentile : percentiles)
+    {
+        double expected = percentile * 10000;
+        double value = (double)histogram.percentile(percentile);
+        EXPECT_LE(expected, value);
+        EXPECT_GE(expected * 1.07, value);
+    }
+
+    histogram.reset();
+    EXPECT_EQ(0U, histogram.count());
+    EXPECT_EQ(0U, histogram.percentile(100));
+}
+
+// Every value falls within the bucket it is counted in
+TEST(test_latency_histogram, buckets)
+{
+    std::vector<uint64_t> values = {0,  1,  31,   32,   33,       63,
+                                    64, 65, 1000, 1001, 123456789};
+    values.push_back(std::numeric_limits<uint64_t>::max());
+
+    for (auto value : values)
+    {
+        auto index = chunkie::latency_histogram::bucket_index(value);
+        EXPECT_GE(chunkie::latency_histogram::highest_value(index), value);
+
+        if (index > 0)
+        {
+            EXPECT_LT(chunkie::latency_histogram::highest_value(index - 1),
+                      value);
+        }
+    }
+
+    uint32_t bucket_count = chunkie::latency_histogram::bucket_count;
+    EXPECT_EQ(bucket_count - 1, chunkie::latency_histogram::bucket_index(
+                                    std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(test_latency_histogram, concurrent)
+{
+    chunkie::latency_histogram histogram;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&histogram, t]()
+            {
+                for (uint64_t i = 0; i < 10000; ++i)
+                {
+                    histogram.record(t * 10000 + i);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(40000U, histogram.count());
+    EXPECT_EQ(39999U, histogram.max());
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/mpsc_queue.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct node
+{
+    uint32_t m_producer = 0;
+    uint32_t m_value = 0;
+    std::atomic<node*> m_next{nullptr};
+};
+}
+
+TEST(test_mpsc_queue, basic)
+{
+    chunkie::mpsc_queue<node> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.pop());
+
+    std::vector<node> nodes(4);
+    for (uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i].m_value = i;
+        queue.push(&nodes[i]);
+    }
+    EXPECT_FALSE(queue.empty());
+
+    for (uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        node* popped = queue.pop();
+        ASSERT_NE(nullptr, popped);
+        EXPECT_EQ(i, popped->m_value);
+    }
+
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.empty());
+
+    // Nodes can be pushed again once popped
+    queue.push(&nodes[2]);
+    EXPECT_EQ(&nodes[2], queue.pop());
+    EXPECT_EQ(nullptr, queue.pop());
+}
+
+// The nodes of each producer are popped in the order they were pushed
+TEST(test_mpsc_queue, threads)
+{
+    chunkie::mpsc_queue<node> queue;
+
+    const uint32_t producers = 4;
+    const uint32_t values = 10000;
+
+    std::vector<std::vector<node>> nodes(producers);
+    for (auto& n : nodes)
+    {
+        n = std::vector<node>(values);
+    }
+    std::vector<std::thread> threads;
+
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(
+            [&queue, &nodes, p]()
+            {
+                for (uint32_t i = 0; i < values; ++i)
+                {
+                    nodes[p][i].m_producer = p;
+                    nodes[p][i].m_value = i;
+                    queue.push(&nodes[p][i]);
+                }
+            });
+    }
+
+    std::vector<uint32_t> expected(producers, 0);
+    uint32_t popped = 0;
+
+    while (popped < producers * values)
+    {
+        node* n = queue.pop();
+        if (n == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        EXPECT_EQ(expected[n->m_producer], n->m_value);
+        expected[n->m_producer]++;
+        popped++;
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/multipath_deserializer.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Serializes objects of increasing size into buffers of at most 20 bytes
+std::vector<std::vector<uint8_t>> serialize(uint32_t objects)
+{
+    chunkie::serializer<uint16_t> serializer;
+    std::vector<std::vector<uint8_t>> buffers;
+
+    for (uint32_t i = 0; i < objects; ++i)
+    {
+        std::vector<uint8_t> object(i + 1, (uint8_t)i);
+        serializer.set_object(object.data(), (uint16_t)object.size());
+        while (!serializer.object_proccessed())
+        {
+            auto size =
+                std::min<uint16_t>(20, serializer.max_write_buffer_size());
+            std::vector<uint8_t> buffer(size);
+            serializer.write_buffer(buffer.data(), size);
+            buffers.push_back(buffer);
+        }
+    }
+    return buffers;
+}
+
+std::vector<std::vector<uint8_t>> take_objects(
+    chunkie::multipath_deserializer<uint16_t>& deserializer)
+{
+    std::vector<std::vector<uint8_t>> objects;
+    while (deserializer.completed_objects() > 0)
+    {
+        std::vector<uint8_t> object;
+        deserializer.take_object(object);
+        objects.push_back(object);
+    }
+    return objects;
+}
+}
+
+// Two paths losing different buffers, the second path lagging behind
+TEST(test_multipath_deserializer, two_paths)
+{
+    auto buffers = serialize(40);
+    chunkie::multipath_deserializer<uint16_t> deserializer(64, 20);
+
+    const uint64_t lag = 5;
+    uint64_t count = buffers.size();
+
+    for (uint64_t i = 0; i < count + lag; ++i)
+    {
+        if (i < count && i % 7 != 3)
+        {
+            EXPECT_TRUE(deserializer.read_buffer(
+                i, buffers[i].data(), (uint16_t)buffers[i].size()));
+        }
+
+        uint64_t j = i - lag;
+        if (i >= lag && j % 7 != 5)
+        {
+            // Only the buffers lost on the first path are used
+            EXPECT_EQ(j % 7 == 3,
+                      deserializer.read_buffer(j, buffers[j].data(),
+                                               (uint16_t)buffers[j].size()));
+        }
+    }
+
+    EXPECT_EQ(count, deserializer.next_sequence());
+    EXPECT_EQ(0U, deserializer.lost_buffers());
+
+    auto objects = take_objects(deserializer);
+    ASSERT_EQ(40U, objects.size());
+    for (uint32_t i = 0; i < 40; ++i)
+    {
+        EXPECT_EQ(std::vector<uint8_t>(i + 1, (uint8_t)i), objects[i]);
+    }
+}
+
+// Objects complete as soon as the missing buffer arrives from any path
+TEST(test_multipath_deserializer, fill_gap)
+{
+    auto buffers = serialize(40);
+    chunkie::multipath_deserializer<uint16_t> deserializer(64, 20);
+
+    // The first buffer is late, the others are held
+    for (uint64_t i = 1; i < 10; ++i)
+    {
+        deserializer.read_buffer(i, buffers[i].data(),
+                                 (uint16_t)buffers[i].size());
+    }
+    EXPECT_EQ(0U, deserializer.completed_objects());
+    EXPECT_EQ(0U, deserializer.next_sequence());
+
+    // Duplicates of held buffers are dropped
+    EXPECT_FALSE(deserializer.read_buffer(4, buffers[4].data(),
+                                          (uint16_t)buffers[4].size()));
+
+    deserializer.read_buffer(0, buffers[0].data(), (uint16_t)buffers[0].size());
+    EXPECT_EQ(10U, deserializer.next_sequence());
+    EXPECT_LT(0U, deserializer.completed_objects());
+
+    // Duplicates of read buffers are dropped
+    EXPECT_FALSE(deserializer.read_buffer(0, buffers[0].data(),
+                                          (uint16_t)buffers[0].size()));
+    EXPECT_EQ(2U, deserializer.duplicates());
+}
+
+// Missing buffers are given up on when the window overflows or on flush
+TEST(test_multipath_deserializer, give_up)
+{
+    auto buffers = serialize(90);
+    ASSERT_LT(200U, buffers.size());
+
+    chunkie::multipath_deserializer<uint16_t> deserializer(64, 20);
+
+    for (uint64_t i = 1; i < 100; ++i)
+    {
+        deserializer.read_buffer(i, buffers[i].data(),
+                                 (uint16_t)buffers[i].size());
+    }
+    EXPECT_EQ(1U, deserializer.lost_buffers());
+    EXPECT_EQ(100U, deserializer.next_sequence());
+
+    // Too late, the window has moved on
+    EXPECT_FALSE(deserializer.read_buffer(0, buffers[0].data(),
+                                          (uint16_t)buffers[0].size()));
+
+    for (uint64_t i = 101; i < 150; ++i)
+    {
+        deserializer.read_buffer(i, buffers[i].data(),
+                                 (uint16_t)buffers[i].size());
+    }
+    EXPECT_EQ(100U, deserializer.next_sequence());
+
+    deserializer.flush();
+    EXPECT_EQ(2U, deserializer.lost_buffers());
+    EXPECT_EQ(150U, deserializer.next_sequence());
+
+    for (uint64_t i = 150; i < buffers.size(); ++i)
+    {
+        deserializer.read_buffer(i, buffers[i].data(),
+                                 (uint16_t)buffers[i].size());
+    }
+    EXPECT_EQ(buffers.size(), deserializer.next_sequence());
+
+    // Only the objects in the lost buffers are missing
+    auto objects = take_objects(deserializer);
+    EXPECT_LT(80U, objects.size());
+    EXPECT_GT(90U, objects.size());
+    EXPECT_EQ(std::vector<uint8_t>(90, 89), objects.back());
+}
+
+// Identifiers may start anywhere and jump far ahead
+TEST(test_multipath_deserializer, jump_ahead)
+{
+    auto buffers = serialize(10);
+    const uint64_t first = 0x100000000;
+
+    chunkie::multipath_deserializer<uint16_t> deserializer(64, 20, first);
+
+    for (uint64_t i = 0; i < buffers.size(); ++i)
+    {
+        EXPECT_TRUE(deserializer.read_buffer(first + i, buffers[i].data(),
+                                             (uint16_t)buffers[i].size()));
+    }
+    EXPECT_EQ(0U, deserializer.lost_buffers());
+    EXPECT_EQ(10U, take_objects(deserializer).size());
+
+    // A buffer far ahead moves the window in one step
+    const uint64_t jump = first + 0x100000000;
+    deserializer.read_buffer(jump + 1, buffers[1].data(),
+                             (uint16_t)buffers[1].size());
+    EXPECT_EQ(jump + 1 - 63, deserializer.next_sequence());
+    EXPECT_EQ(jump + 1 - 63 - first - buffers.size(),
+              deserializer.lost_buffers());
+
+    // Held buffers are read before the window moves on
+    deserializer.read_buffer(jump + 1000, buffers[0].data(),
+                             (uint16_t)buffers[0].size());
+    EXPECT_EQ(jump + 1000 - 63, deserializer.next_sequence());
+
+    deserializer.flush();
+    EXPECT_EQ(jump + 1001, deserializer.next_sequence());
+    auto objects = take_objects(deserializer);
+    ASSERT_EQ(2U, objects.size());
+    EXPECT_EQ(std::vector<uint8_t>(2, 1), objects[0]);
+    EXPECT_EQ(std::vector<uint8_t>(1, 0), objects[1]);
+}
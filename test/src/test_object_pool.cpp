@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/object_pool.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST(test_object_pool, basic)
+{
+    chunkie::object_pool pool;
+    EXPECT_EQ(0U, pool.free_objects());
+
+    const uint8_t* data = nullptr;
+
+    {
+        auto object = pool.acquire(10);
+        EXPECT_TRUE((bool)object);
+        EXPECT_EQ(10U, object.size());
+        EXPECT_EQ(1U, object.use_count());
+
+        auto copy = object;
+        EXPECT_EQ(2U, object.use_count());
+        EXPECT_EQ(object.data(), copy.data());
+
+        data = object.data();
+        object.reset();
+        EXPECT_FALSE((bool)object);
+        EXPECT_EQ(1U, copy.use_count());
+        EXPECT_EQ(0U, pool.free_objects());
+    }
+
+    // The storage has been returned and is reused
+    EXPECT_EQ(1U, pool.free_objects());
+    auto object = pool.acquire(5);
+    EXPECT_EQ(0U, pool.free_objects());
+    EXPECT_EQ(5U, object.size());
+    EXPECT_EQ(data, object.data());
+}
+
+TEST(test_object_pool, outlive_pool)
+{
+    chunkie::shared_object object;
+
+    {
+        chunkie::object_pool pool;
+        object = pool.acquire(4);
+        chunkie::object_pool::mutable_data(object)[0] = 42;
+    }
+
+    EXPECT_EQ(4U, object.size());
+    EXPECT_EQ(42U, object.data()[0]);
+}
+
+TEST(test_object_pool, release_from_threads)
+{
+    chunkie::object_pool pool;
+
+    std::vector<chunkie::shared_object> objects;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        objects.push_back(pool.acquire(100));
+    }
+
+    std::vector<std::thread> consumers;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        consumers.emplace_back([objects]() mutable { objects.clear(); });
+    }
+
+    objects.clear();
+
+    for (auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    EXPECT_EQ(8U, pool.free_objects());
+}
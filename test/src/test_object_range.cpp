@@ -0,0 +1,75 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/buffer_range.hpp>
+#include <chunkie/deserializer.hpp>
+#include <chunkie/object_range.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <vector>
+
+TEST(test_object_range, objects)
+{
+    chunkie::deserializer<uint8_t> deserializer;
+
+    // The second buffer is lost, which drops the object split over the
+    // first three buffers
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0b10000000 | 2, 0, 1, 0b10000000 | 5, 2},
+        {0b10000000 | 4, 3, 4, 5},
+        {2, 5, 6, 0b10000000 | 2, 7},
+        {1, 8, 0b10000000 | 1, 9, 0}};
+
+    std::vector<std::vector<uint8_t>> expected_objects = {{0, 1}, {7, 8}, {9}};
+
+    std::vector<uint8_t> storage;
+    std::vector<std::vector<uint8_t>> objects;
+
+    buffers.erase(buffers.begin() + 1);
+    for (auto object : chunkie::make_object_range(
+             deserializer, buffers.begin(), buffers.end(), storage))
+    {
+        objects.emplace_back(object.m_data, object.m_data + object.m_size);
+    }
+
+    EXPECT_EQ(expected_objects, objects);
+    EXPECT_TRUE(deserializer.buffer_proccessed());
+}
+
+// A buffer_range feeds an object_range without storing the buffers
+TEST(test_object_range, pipeline)
+{
+    chunkie::serializer<uint16_t> serializer;
+    chunkie::deserializer<uint16_t> deserializer;
+
+    std::vector<uint8_t> buffer(100);
+    std::vector<uint8_t> storage;
+
+    for (uint16_t size : {1, 50, 97, 98, 99, 1000})
+    {
+        std::vector<uint8_t> object(size);
+        for (uint16_t i = 0; i < size; ++i)
+        {
+            object[i] = (uint8_t)(i * 7);
+        }
+
+        serializer.set_object(object.data(), size);
+        auto buffers =
+            chunkie::make_buffer_range(serializer, buffer.data(), 100);
+
+        uint32_t count = 0;
+        for (auto view : chunkie::make_object_range(
+                 deserializer, buffers.begin(), buffers.end(), storage))
+        {
+            EXPECT_EQ(object, std::vector<uint8_t>(view.m_data,
+                                                   view.m_data + view.m_size));
+            count++;
+        }
+        EXPECT_EQ(1U, count);
+        EXPECT_TRUE(serializer.object_proccessed());
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/pooled_deserializer.hpp>
+
+#include <vector>
+
+// object spanning 2 and 3 buffers
+TEST(test_pooled_deserializer, buffer_overlap_objects)
+{
+    chunkie::object_pool pool;
+    chunkie::pooled_deserializer<uint32_t> deserializer(pool);
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0b10000000, 0, 0, 4, 0, 1},
+        {0b00000000, 0, 0, 2, 2, 3, 0b10000000, 0, 0, 17, 4, 5, 6, 7, 8, 9},
+        {0b00000000, 0, 0, 11, 10, 11, 12},
+        {0b00000000, 0, 0, 8, 13, 14, 15, 16, 17, 18, 19, 20, 0b10000000, 0, 0,
+         1, 21},
+        {0b10000000, 0, 0, 3, 22, 23, 24}};
+
+    std::vector<std::vector<uint8_t>> expected_object = {
+        {0, 1, 2, 3},
+        {4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20},
+        {21},
+        {22, 23, 24}};
+
+    std::vector<chunkie::shared_object> objects;
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.set_buffer(buffer.data(), buffer.size());
+
+        while (!deserializer.buffer_proccessed())
+        {
+            deserializer.write_to_object();
+            if (deserializer.object_completed())
+            {
+                objects.push_back(deserializer.release_object());
+            }
+        }
+    }
+
+    ASSERT_EQ(expected_object.size(), objects.size());
+    for (uint32_t i = 0; i < objects.size(); ++i)
+    {
+        std::vector<uint8_t> object(objects[i].data(),
+                                    objects[i].data() + objects[i].size());
+        EXPECT_EQ(expected_object[i], object);
+    }
+
+    // Dropping the handles returns the storage to the pool
+    objects.clear();
+    EXPECT_EQ(expected_object.size(), pool.free_objects());
+}
+
+// Objects are recycled once all consumers have dropped them
+TEST(test_pooled_deserializer, recycle)
+{
+    chunkie::object_pool pool;
+    chunkie::pooled_deserializer<uint8_t> deserializer(pool);
+
+    std::vector<uint8_t> buffer = {0b10000000 | 3, 1, 2, 3};
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        deserializer.set_buffer(buffer.data(), (uint8_t)buffer.size());
+        deserializer.write_to_object();
+        EXPECT_TRUE(deserializer.object_completed());
+        EXPECT_TRUE(deserializer.buffer_proccessed());
+
+        auto object = deserializer.release_object();
+        auto consumer = object;
+        EXPECT_EQ(2U, object.use_count());
+        EXPECT_EQ(3U, consumer.size());
+        EXPECT_EQ(3U, consumer.data()[2]);
+    }
+
+    EXPECT_EQ(1U, pool.free_objects());
+}
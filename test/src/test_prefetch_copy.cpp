@@ -0,0 +1,33 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/prefetch_copy.hpp>
+
+#include <algorithm>
+#include <vector>
+
+TEST(test_prefetch_copy, copy)
+{
+    std::vector<uint8_t> source(10000);
+    for (std::size_t i = 0; i < source.size(); ++i)
+    {
+        source[i] = (uint8_t)(i * 3);
+    }
+
+    std::vector<std::size_t> sizes = {0, 1, 255, 256, 1023, 1024, 1300, 10000};
+
+    for (auto size : sizes)
+    {
+        std::vector<uint8_t> destination(size + 1, 0);
+        chunkie::prefetch_copy::copy(destination.data(), source.data(), size,
+                                     size);
+
+        EXPECT_TRUE(std::equal(source.begin(), source.begin() + size,
+                               destination.begin()));
+        EXPECT_EQ(0U, destination[size]);
+    }
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/priority_serializer.hpp>
+
+#include <vector>
+
+TEST(test_priority_serializer, write_buffer)
+{
+    chunkie::priority_serializer<uint8_t> serializer(2);
+    EXPECT_EQ(2U, serializer.lanes());
+    EXPECT_FALSE(serializer.has_objects());
+
+    std::vector<uint8_t> bulk = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<uint8_t> urgent = {9, 9};
+
+    serializer.push_object(1, bulk.data(), (uint8_t)bulk.size());
+    EXPECT_TRUE(serializer.has_objects());
+
+    std::vector<uint8_t> buffer(6);
+    EXPECT_EQ(6U, serializer.write_buffer(buffer.data(), 6));
+    EXPECT_EQ(std::vector<uint8_t>({1, 0b10000000 | 8, 1, 2, 3, 4}), buffer);
+
+    // The urgent object preempts the remainder of the bulk object
+    serializer.push_object(0, urgent.data(), (uint8_t)urgent.size());
+    serializer.push_object(0, urgent.data(), (uint8_t)urgent.size());
+    EXPECT_EQ(2U, serializer.queued_objects(0));
+
+    EXPECT_EQ(6U, serializer.write_buffer(buffer.data(), 6));
+    std::vector<uint8_t> expected = {0, 0b10000000 | 2, 9, 9, 0b10000000 | 2,
+                                     9};
+    EXPECT_EQ(expected, buffer);
+    EXPECT_EQ(1U, serializer.completed_objects(0));
+
+    buffer.assign(6, 0);
+    EXPECT_EQ(3U, serializer.write_buffer(buffer.data(), 6));
+    EXPECT_EQ(std::vector<uint8_t>({0, 1, 9, 0, 0, 0}), buffer);
+    EXPECT_EQ(2U, serializer.completed_objects(0));
+
+    // The bulk object continues where it was left
+    EXPECT_EQ(6U, serializer.write_buffer(buffer.data(), 6));
+    EXPECT_EQ(std::vector<uint8_t>({1, 4, 5, 6, 7, 8}), buffer);
+    EXPECT_EQ(1U, serializer.completed_objects(1));
+
+    EXPECT_FALSE(serializer.has_objects());
+    EXPECT_EQ(0U, serializer.write_buffer(buffer.data(), 6));
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/receive_engine.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(test_receive_engine, many_streams)
+{
+    const uint32_t streams = 16;
+    const uint32_t objects_per_stream = 50;
+    const uint32_t max_buffer_size = 100;
+
+    // Serialize the objects of every stream into buffers
+    std::map<uint64_t, std::vector<std::vector<uint8_t>>> objects;
+    std::map<uint64_t, std::vector<std::vector<uint8_t>>> buffers;
+
+    for (uint64_t stream = 0; stream < streams; ++stream)
+    {
+        chunkie::serializer<uint32_t> serializer;
+
+        for (uint32_t i = 0; i < objects_per_stream; ++i)
+        {
+            std::vector<uint8_t> object(1 + (rand() % 500));
+            for (auto& byte : object)
+            {
+                byte = (uint8_t)rand();
+            }
+
+            serializer.set_object(object.data(), (uint32_t)object.size());
+            while (!serializer.object_proccessed())
+            {
+                std::vector<uint8_t> buffer(std::min<uint32_t>(
+                    max_buffer_size, serializer.max_write_buffer_size()));
+                serializer.write_buffer(buffer.data(),
+                                        (uint32_t)buffer.size());
+                buffers[stream].push_back(buffer);
+            }
+
+            objects[stream].push_back(object);
+        }
+    }
+
+    std::mutex mutex;
+    std::map<uint64_t, std::vector<std::vector<uint8_t>>> received;
+
+    {
+        chunkie::receive_engine<uint32_t> engine(
+            4, 8,
+            [&](uint64_t stream, chunkie::shared_object object)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                received[stream].emplace_back(object.data(),
+                                              object.data() + object.size());
+            });
+
+        EXPECT_EQ(4U, engine.threads());
+
+        // Interleave the buffers of the streams
+        bool pushed = true;
+        for (std::size_t i = 0; pushed; ++i)
+        {
+            pushed = false;
+            for (auto& stream : buffers)
+            {
+                if (i < stream.second.size())
+                {
+                    engine.push(stream.first, stream.second[i]);
+                    pushed = true;
+                }
+            }
+        }
+
+        engine.stop();
+    }
+
+    EXPECT_EQ(objects, received);
+}
+
+// Idle workers sleep and are woken up by new buffers
+TEST(test_receive_engine, idle_workers)
+{
+    std::atomic<uint32_t> received{0};
+
+    chunkie::receive_engine<uint8_t> engine(
+        2, 2,
+        [&received](uint64_t, chunkie::shared_object)
+        { received.fetch_add(1, std::memory_order_relaxed); });
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        // Long enough for the workers to fall asleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        engine.push(i, std::vector<uint8_t>({0b10000000 | 1, (uint8_t)i}));
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (received.load() != i + 1 &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(i + 1, received.load());
+    }
+
+    engine.stop();
+}
+
+TEST(test_receive_engine, worker_index)
+{
+    chunkie::receive_engine<uint16_t> engine(
+        3, 2, [](uint64_t, chunkie::shared_object) {});
+
+    for (uint64_t stream = 0; stream < 100; ++stream)
+    {
+        auto index = engine.worker_index(stream);
+        EXPECT_GT(3U, index);
+        EXPECT_EQ(index, engine.worker_index(stream));
+    }
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/rechunker.hpp>
+#include <chunkie/serializer.hpp>
+
+#include <vector>
+
+namespace
+{
+// Move all input buffers to output buffers of the given size
+template <typename Rechunker>
+std::vector<std::vector<uint8_t>>
+rechunk(Rechunker& rechunker, const std::vector<std::vector<uint8_t>>& inputs,
+        std::size_t output_size)
+{
+    std::vector<std::vector<uint8_t>> outputs;
+    std::vector<uint8_t> output(output_size);
+
+    rechunker.set_output(output.data(), output.size());
+    for (const auto& input : inputs)
+    {
+        rechunker.set_input(input.data(), input.size());
+        while (!rechunker.input_proccessed())
+        {
+            rechunker.write();
+            if (rechunker.output_full())
+            {
+                outputs.emplace_back(output.begin(),
+                                     output.begin() + rechunker.output_size());
+                rechunker.set_output(output.data(), output.size());
+            }
+        }
+    }
+
+    if (rechunker.output_size() > 0)
+    {
+        outputs.emplace_back(output.begin(),
+                             output.begin() + rechunker.output_size());
+    }
+    return outputs;
+}
+}
+
+TEST(test_rechunker, split_and_join)
+{
+    chunkie::rechunker<uint8_t> rechunker;
+
+    // Two objects of 5 and 2 bytes followed by zero padding
+    std::vector<std::vector<uint8_t>> inputs = {
+        {0b10000000 | 5, 0, 1, 2}, {2, 3, 4, 0b10000000 | 2, 5, 6, 0, 0}};
+
+    // Fragments of the same object are joined across input buffers
+    std::vector<std::vector<uint8_t>> expected = {
+        {0b10000000 | 5, 0, 1, 2, 3},
+        {1, 4, 0b10000000 | 2, 5, 6}};
+
+    EXPECT_EQ(expected, rechunk(rechunker, inputs, 5));
+}
+
+// Objects are continued only if their start was received
+TEST(test_rechunker, lost_buffer)
+{
+    chunkie::rechunker<uint16_t, uint8_t> rechunker;
+
+    std::vector<std::vector<uint8_t>> inputs = {
+        // the continuation of an object started in a lost buffer
+        {0, 2, 1, 2, 0b10000000, 3, 3, 4},
+        // lost: {0, 1, 5}
+        {0, 1, 5, 0b10000000, 1, 6},
+        // an object too large for the output header
+        {0b10000000, 200, 7, 8}};
+
+    inputs.erase(inputs.begin() + 1);
+
+    std::vector<std::vector<uint8_t>> expected = {{0b10000000 | 3, 3, 4}};
+
+    EXPECT_EQ(expected, rechunk(rechunker, inputs, 10));
+}
+
+// An object cut short by a lost buffer ends the output buffer
+TEST(test_rechunker, truncated_object)
+{
+    chunkie::rechunker<uint8_t> rechunker;
+
+    std::vector<std::vector<uint8_t>> inputs = {
+        {0b10000000 | 10, 0, 1, 2, 3},
+        // lost: {6, 4, 5, 6, 7, 8, 9, 0b10000000 | 2, 10, 11}
+        {0b10000000 | 2, 12, 13},
+        {0b10000000 | 10, 0, 1, 2, 3},
+        // lost: {6, 4, 5, 6, 7}
+        {2, 8, 9, 0b10000000 | 1, 14}};
+
+    std::vector<std::vector<uint8_t>> expected = {
+        {0b10000000 | 10, 0, 1, 2, 3},
+        {0b10000000 | 2, 12, 13, 0b10000000 | 10, 0, 1, 2, 3},
+        {0b10000000 | 1, 14}};
+
+    auto outputs = rechunk(rechunker, inputs, 20);
+    EXPECT_EQ(expected, outputs);
+
+    // Only the complete objects are deserialized
+    chunkie::deserializer<uint8_t> deserializer;
+    std::vector<std::vector<uint8_t>> received;
+    std::vector<uint8_t> object;
+    for (const auto& output : outputs)
+    {
+        deserializer.set_buffer(output.data(), (uint8_t)output.size());
+        while (!deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                received.push_back(object);
+            }
+        }
+    }
+
+    expected = {{12, 13}, {14}};
+    EXPECT_EQ(expected, received);
+}
+
+TEST(test_rechunker, serialize_rechunk_deserialize)
+{
+    chunkie::serializer<uint32_t> serializer;
+    chunkie::rechunker<uint32_t, uint16_t> rechunker;
+    chunkie::deserializer<uint16_t> deserializer;
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t size : {1337, 28, 2681, 540, 12, 1, 24, 1024, 257, 42})
+    {
+        objects.emplace_back(size, (uint8_t)size);
+    }
+
+    // Concatenated buffers of 1000 bytes
+    std::vector<std::vector<uint8_t>> inputs;
+    std::vector<uint8_t> buffer;
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+        while (!serializer.object_proccessed())
+        {
+            if (1000 - buffer.size() <= 4)
+            {
+                inputs.push_back(buffer);
+                buffer.clear();
+            }
+            auto size = std::min<uint32_t>(1000 - (uint32_t)buffer.size(),
+                                           serializer.max_write_buffer_size());
+            auto offset = buffer.size();
+            buffer.resize(offset + size);
+            serializer.write_buffer(buffer.data() + offset, size);
+        }
+    }
+    inputs.push_back(buffer);
+
+    auto outputs = rechunk(rechunker, inputs, 300);
+
+    std::vector<std::vector<uint8_t>> received;
+    std::vector<uint8_t> object;
+    for (const auto& output : outputs)
+    {
+        EXPECT_GE(300U, output.size());
+        deserializer.set_buffer(output.data(), (uint16_t)output.size());
+        while (!deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                received.push_back(object);
+            }
+        }
+    }
+
+    EXPECT_EQ(objects, received);
+}
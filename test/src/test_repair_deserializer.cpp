@@ -0,0 +1,270 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/repair_deserializer.hpp>
+#include <chunkie/repair_serializer.hpp>
+
+#include <endian/big_endian.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using nack_type = chunkie::nack<uint16_t>;
+
+TEST(test_repair_deserializer, missing_ranges)
+{
+    chunkie::repair_deserializer<uint16_t> deserializer;
+
+    // Object 0 of size 10 with bytes 2 to 5 missing
+    std::vector<uint8_t> first = {0, 0, 0, 0, 0, 10, 0, 0, 0, 1};
+    std::vector<uint8_t> second = {0, 0, 0, 0, 0, 10, 0, 6, 6, 7, 8, 9};
+    // Object 3, objects 1 and 2 are missing entirely
+    std::vector<uint8_t> third = {0, 0, 0, 3, 0, 4, 0, 0, 1, 1};
+
+    deserializer.read_buffer(first.data(), (uint16_t)first.size());
+    deserializer.read_buffer(second.data(), (uint16_t)second.size());
+    deserializer.read_buffer(third.data(), (uint16_t)third.size());
+
+    EXPECT_EQ(0U, deserializer.completed_objects());
+    EXPECT_EQ(2U, deserializer.partial_objects());
+
+    std::vector<nack_type> nacks;
+    deserializer.nacks(nacks);
+
+    // The tail of the newest object may still be in flight
+    std::vector<nack_type> expected = {{0, 2, 4}, {1, 0, 0, 2}};
+    EXPECT_EQ(expected, nacks);
+
+    // Fill in the missing range of object 0
+    std::vector<uint8_t> repair = {0, 0, 0, 0, 0, 10, 0, 2, 2, 3, 4, 5};
+    deserializer.read_buffer(repair.data(), (uint16_t)repair.size());
+
+    ASSERT_EQ(1U, deserializer.completed_objects());
+    std::vector<uint8_t> object;
+    EXPECT_EQ(0U, deserializer.take_object(object));
+    EXPECT_EQ(std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), object);
+
+    // Late duplicates of completed objects are ignored
+    deserializer.read_buffer(repair.data(), (uint16_t)repair.size());
+    EXPECT_EQ(0U, deserializer.completed_objects());
+
+    deserializer.abandon(1);
+    nacks.clear();
+    deserializer.nacks(nacks);
+    expected = {{2, 0, 0}};
+    EXPECT_EQ(expected, nacks);
+}
+
+// Overlapping fragments are merged
+TEST(test_repair_deserializer, overlapping_fragments)
+{
+    chunkie::repair_deserializer<uint8_t> deserializer;
+
+    std::vector<std::vector<uint8_t>> buffers = {
+        {0, 0, 0, 0, 6, 1, 1, 2},
+        {0, 0, 0, 0, 6, 4, 4, 5},
+        {0, 0, 0, 0, 6, 0, 0, 1, 2, 3, 4}};
+
+    for (const auto& buffer : buffers)
+    {
+        deserializer.read_buffer(buffer.data(), (uint8_t)buffer.size());
+    }
+
+    ASSERT_EQ(1U, deserializer.completed_objects());
+    std::vector<uint8_t> object;
+    deserializer.take_object(object);
+    EXPECT_EQ(std::vector<uint8_t>({0, 1, 2, 3, 4, 5}), object);
+    EXPECT_EQ(0U, deserializer.partial_objects());
+}
+
+// Lost buffers are recovered by repairing only the missing ranges
+TEST(test_repair_deserializer, lossy_transfer)
+{
+    chunkie::repair_serializer<uint32_t> serializer;
+    chunkie::repair_deserializer<uint32_t> deserializer;
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        std::vector<uint8_t> object(1 + (rand() % 10000));
+        for (auto& byte : object)
+        {
+            byte = (uint8_t)rand();
+        }
+        objects.push_back(object);
+    }
+
+    uint32_t max_buffer_size = 1000;
+    uint64_t sent_bytes = 0;
+    uint64_t repair_bytes = 0;
+
+    auto send = [&](uint64_t& bytes)
+    {
+        while (!serializer.object_proccessed())
+        {
+            std::vector<uint8_t> buffer(std::min<uint32_t>(
+                max_buffer_size, serializer.max_write_buffer_size()));
+            serializer.write_buffer(buffer.data(), (uint32_t)buffer.size());
+            bytes += buffer.size();
+
+            // Lose every fifth buffer
+            if (rand() % 5 != 0)
+            {
+                deserializer.read_buffer(buffer.data(),
+                                         (uint32_t)buffer.size());
+            }
+        }
+    };
+
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+        send(sent_bytes);
+    }
+
+    // Close the gap at the end with an object which is never lost
+    std::vector<uint8_t> last = {1};
+    serializer.set_object(last.data(), (uint32_t)last.size());
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint32_t)buffer.size());
+    deserializer.read_buffer(buffer.data(), (uint32_t)buffer.size());
+
+    std::vector<chunkie::nack<uint32_t>> nacks;
+    deserializer.nacks(nacks);
+
+    while (!nacks.empty())
+    {
+        for (auto missing : nacks)
+        {
+            // Objects missing entirely are repaired one at a time
+            for (uint32_t i = 0, count = missing.m_count; i < count; ++i)
+            {
+                missing.m_count = 1;
+                const auto& object = objects[missing.m_sequence];
+                serializer.set_repair(missing, object.data(),
+                                      (uint32_t)object.size());
+                send(repair_bytes);
+                missing.m_sequence++;
+            }
+        }
+
+        nacks.clear();
+        deserializer.nacks(nacks);
+    }
+
+    std::vector<std::vector<uint8_t>> results(objects.size() + 1);
+    while (deserializer.completed_objects() > 0)
+    {
+        std::vector<uint8_t> object;
+        auto sequence = deserializer.take_object(object);
+        results[sequence] = object;
+    }
+
+    results.pop_back();
+    EXPECT_EQ(objects, results);
+    EXPECT_GT(sent_bytes, repair_bytes);
+}
+
+// Sequence numbers wrap around, and only a window of them is kept
+TEST(test_repair_deserializer, sequence_window)
+{
+    chunkie::repair_deserializer<uint16_t> deserializer(100, 16);
+
+    auto read = [&deserializer](uint32_t sequence, uint16_t size,
+                                std::vector<uint8_t> data)
+    {
+        std::vector<uint8_t> buffer(chunkie::repair_deserializer<
+                                    uint16_t>::header_size);
+        endian::big_endian::put<uint32_t>(sequence, buffer.data());
+        endian::big_endian::put<uint16_t>(size, buffer.data() + 4);
+        endian::big_endian::put<uint16_t>(0, buffer.data() + 6);
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        deserializer.read_buffer(buffer.data(), (uint16_t)buffer.size());
+    };
+
+    // Joining the stream just before the sequence numbers wrap
+    read(0xFFFFFFFE, 1, {1});
+    read(1, 1, {2});
+
+    std::vector<nack_type> nacks;
+    deserializer.nacks(nacks);
+    std::vector<nack_type> expected = {{0xFFFFFFFF, 0, 0, 2}};
+    EXPECT_EQ(expected, nacks);
+
+    // A missing object after the wrap is still completed
+    read(0, 1, {3});
+    EXPECT_EQ(3U, deserializer.completed_objects());
+
+    // Objects too large, and sequence numbers far ahead, are dropped
+    read(2, 101, std::vector<uint8_t>(101));
+    read(0x7FFFFFFF, 1, {4});
+    EXPECT_EQ(3U, deserializer.completed_objects());
+    EXPECT_EQ(0U, deserializer.partial_objects());
+
+    // A gap is kept as a single range, trimmed to the window
+    read(16, 2, {5});
+    read(30, 1, {6});
+    EXPECT_EQ(4U, deserializer.completed_objects());
+
+    nacks.clear();
+    deserializer.nacks(nacks);
+    expected = {{15, 0, 0}, {16, 1, 1}, {17, 0, 0, 13}};
+    EXPECT_EQ(expected, nacks);
+
+    // Objects older than the window are abandoned
+    read(40, 1, {7});
+    EXPECT_EQ(0U, deserializer.partial_objects());
+    read(16, 2, {5, 5});
+    read(41, 1, {8});
+    EXPECT_EQ(6U, deserializer.completed_objects());
+
+    // After losing more objects than the window the sequence restarts
+    for (uint32_t sequence = 100; sequence < 115; ++sequence)
+    {
+        read(sequence, 1, {9});
+    }
+    EXPECT_EQ(6U, deserializer.completed_objects());
+    read(115, 1, {9});
+    read(116, 1, {9});
+    EXPECT_EQ(8U, deserializer.completed_objects());
+    nacks.clear();
+    deserializer.nacks(nacks);
+    EXPECT_TRUE(nacks.empty());
+}
+
+// The oldest partial objects are abandoned to bound the memory held
+TEST(test_repair_deserializer, memory_bound)
+{
+    chunkie::repair_deserializer<uint16_t> deserializer(10, 16, 25);
+
+    // The first bytes of objects 0, 1 and 2 of size 10
+    for (uint8_t sequence = 0; sequence < 3; ++sequence)
+    {
+        std::vector<uint8_t> buffer = {0, 0, 0, sequence, 0, 10, 0, 0, 1};
+        deserializer.read_buffer(buffer.data(), (uint16_t)buffer.size());
+    }
+
+    // Object 0 made room for object 2
+    EXPECT_EQ(2U, deserializer.partial_objects());
+    EXPECT_EQ(20U, deserializer.partial_bytes());
+
+    // Objects larger than the maximum are dropped
+    std::vector<uint8_t> large = {0, 0, 0, 3, 0, 11, 0, 0, 1};
+    deserializer.read_buffer(large.data(), (uint16_t)large.size());
+    EXPECT_EQ(2U, deserializer.partial_objects());
+
+    // Completing object 1 releases its memory
+    std::vector<uint8_t> rest = {0, 0, 0, 1, 0, 10, 0, 1,
+                                 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    deserializer.read_buffer(rest.data(), (uint16_t)rest.size());
+    EXPECT_EQ(1U, deserializer.completed_objects());
+    EXPECT_EQ(1U, deserializer.partial_objects());
+    EXPECT_EQ(10U, deserializer.partial_bytes());
+
+    deserializer.abandon(2);
+    EXPECT_EQ(0U, deserializer.partial_bytes());
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/repair_serializer.hpp>
+
+#include <vector>
+
+TEST(test_repair_serializer, write_buffer)
+{
+    using serializer_type = chunkie::repair_serializer<uint8_t>;
+    serializer_type serializer;
+
+    EXPECT_EQ(6U, serializer_type::header_size);
+
+    std::vector<uint8_t> object = {1, 2, 3, 4, 5};
+    EXPECT_EQ(0U, serializer.set_object(object.data(), (uint8_t)object.size()));
+    EXPECT_EQ(11U, serializer.max_write_buffer_size());
+
+    std::vector<uint8_t> first(9);
+    serializer.write_buffer(first.data(), (uint8_t)first.size());
+    EXPECT_EQ(std::vector<uint8_t>({0, 0, 0, 0, 5, 0, 1, 2, 3}), first);
+
+    std::vector<uint8_t> second(serializer.max_write_buffer_size());
+    serializer.write_buffer(second.data(), (uint8_t)second.size());
+    EXPECT_EQ(std::vector<uint8_t>({0, 0, 0, 0, 5, 3, 4, 5}), second);
+    EXPECT_TRUE(serializer.object_proccessed());
+
+    EXPECT_EQ(1U, serializer.set_object(object.data(), (uint8_t)object.size()));
+    EXPECT_EQ(2U, serializer.next_sequence());
+}
+
+// Repairs regenerate only the requested range
+TEST(test_repair_serializer, repair)
+{
+    chunkie::repair_serializer<uint8_t> serializer;
+
+    std::vector<uint8_t> object = {1, 2, 3, 4, 5};
+    serializer.set_object(object.data(), (uint8_t)object.size());
+    while (!serializer.object_proccessed())
+    {
+        std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+        serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+    }
+
+    serializer.set_repair({0, 1, 2}, object.data(), (uint8_t)object.size());
+    EXPECT_EQ(8U, serializer.max_write_buffer_size());
+
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+    EXPECT_EQ(std::vector<uint8_t>({0, 0, 0, 0, 5, 1, 2, 3}), buffer);
+    EXPECT_TRUE(serializer.object_proccessed());
+
+    // A length of zero repairs the whole object
+    serializer.set_repair({0, 0, 0}, object.data(), (uint8_t)object.size());
+    EXPECT_EQ(11U, serializer.max_write_buffer_size());
+}
+
+// Objects set before the sequence number wrapped around can be repaired
+TEST(test_repair_serializer, repair_across_wrap)
+{
+    chunkie::repair_serializer<uint8_t> serializer(0xFFFFFFFE);
+
+    std::vector<uint8_t> object = {1, 2, 3, 4, 5};
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        serializer.set_object(object.data(), (uint8_t)object.size());
+        while (!serializer.object_proccessed())
+        {
+            std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+            serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+        }
+    }
+    EXPECT_EQ(2U, serializer.next_sequence());
+
+    serializer.set_repair({0xFFFFFFFF, 3, 2}, object.data(),
+                          (uint8_t)object.size());
+
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+    EXPECT_EQ(std::vector<uint8_t>({0xFF, 0xFF, 0xFF, 0xFF, 5, 3, 4, 5}),
+              buffer);
+    EXPECT_TRUE(serializer.object_proccessed());
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/rle_codec.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+TEST(test_rle_codec, encode)
+{
+    std::vector<uint8_t> data = {1, 2, 0, 0, 0, 0, 3, 3, 4};
+    std::vector<uint8_t> expected = {1, 1, 2, 128 + 1, 0, 2, 3, 3, 4};
+
+    std::vector<uint8_t> output(data.size());
+    auto size = chunkie::rle_codec::encode(data.data(), data.size(),
+                                           output.data(), output.size());
+    output.resize(size);
+    EXPECT_EQ(expected, output);
+
+    std::vector<uint8_t> decoded(data.size());
+    EXPECT_TRUE(chunkie::rle_codec::decode(output.data(), output.size(),
+                                           decoded.data(), decoded.size()));
+    EXPECT_EQ(data, decoded);
+}
+
+// Encoding fails if the output is too small
+TEST(test_rle_codec, capacity)
+{
+    std::vector<uint8_t> data = {1, 2, 3, 4};
+    std::vector<uint8_t> output(4);
+
+    EXPECT_EQ(0U, chunkie::rle_codec::encode(data.data(), data.size(),
+                                             output.data(), output.size()));
+
+    std::vector<uint8_t> zeros(1000, 0);
+    auto size = chunkie::rle_codec::encode(zeros.data(), zeros.size(),
+                                           output.data(), output.size());
+    EXPECT_EQ(0U, size);
+
+    output.resize(16);
+    size = chunkie::rle_codec::encode(zeros.data(), zeros.size(),
+                                      output.data(), output.size());
+    EXPECT_EQ(16U, size);
+}
+
+// Malformed encodings are rejected
+TEST(test_rle_codec, decode_invalid)
+{
+    std::vector<uint8_t> output(4);
+
+    std::vector<uint8_t> truncated = {3, 1, 2};
+    EXPECT_FALSE(chunkie::rle_codec::decode(truncated.data(), truncated.size(),
+                                            output.data(), output.size()));
+
+    std::vector<uint8_t> too_long = {128 + 2, 7};
+    EXPECT_FALSE(chunkie::rle_codec::decode(too_long.data(), too_long.size(),
+                                            output.data(), output.size()));
+
+    std::vector<uint8_t> too_short = {128, 7};
+    EXPECT_FALSE(chunkie::rle_codec::decode(too_short.data(), too_short.size(),
+                                            output.data(), output.size()));
+}
+
+TEST(test_rle_codec, random)
+{
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        std::vector<uint8_t> data(1 + (rand() % 2000));
+        for (auto& byte : data)
+        {
+            // Few different values give both runs and literals
+            byte = (uint8_t)(rand() % 3);
+        }
+
+        std::vector<uint8_t> output(data.size() * 2);
+        auto size = chunkie::rle_codec::encode(data.data(), data.size(),
+                                               output.data(), output.size());
+        ASSERT_LT(0U, size);
+
+        std::vector<uint8_t> decoded(data.size());
+        EXPECT_TRUE(chunkie::rle_codec::decode(output.data(), size,
+                                               decoded.data(), decoded.size()));
+        EXPECT_EQ(data, decoded);
+    }
+}
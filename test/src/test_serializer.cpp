@@ -7,7 +7,10 @@
 
 #include <chunkie/serializer.hpp>
 
+#include "tag_extension.hpp"
+
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 TEST(test_serializer, basic)
@@ -121,3 +124,154 @@ TEST(test_serializer, max_object_size)
     EXPECT_EQ(9223372036854775807U,
               chunkie::serializer<uint64_t>::max_object_size);
 }
+
+// The extension is only written after the start header
+TEST(test_serializer, start_header_extension)
+{
+    using serializer_type = chunkie::serializer<uint8_t, tag_extension>;
+    serializer_type serializer;
+
+    std::vector<uint8_t> object = {1, 2, 3, 4, 5};
+    serializer.set_object(object.data(), (uint8_t)object.size());
+    serializer.extension().m_tag = 0x0102;
+
+    EXPECT_EQ(1U + 2U + 5U, serializer.max_write_buffer_size());
+
+    std::vector<uint8_t> first(5);
+    serializer.write_buffer(first.data(), (uint8_t)first.size());
+    EXPECT_EQ(std::vector<uint8_t>({0b10000000 | 5, 1, 2, 1, 2}), first);
+
+    EXPECT_EQ(1U + 3U, serializer.max_write_buffer_size());
+
+    std::vector<uint8_t> second(serializer.max_write_buffer_size());
+    serializer.write_buffer(second.data(), (uint8_t)second.size());
+    EXPECT_EQ(std::vector<uint8_t>({3, 3, 4, 5}), second);
+    EXPECT_TRUE(serializer.object_proccessed());
+}
+
+// An object made of several segments is written as one object
+TEST(test_serializer, segments)
+{
+    using serializer_type = chunkie::serializer<uint8_t>;
+    serializer_type serializer;
+
+    std::vector<uint8_t> header = {0, 1};
+    std::vector<uint8_t> metadata = {2, 3, 4};
+    std::vector<uint8_t> payload = {5, 6, 7, 8, 9, 10};
+
+    std::vector<chunkie::object_view<uint8_t>> segments = {
+        {header.data(), (uint8_t)header.size()},
+        {nullptr, 0},
+        {metadata.data(), (uint8_t)metadata.size()},
+        {payload.data(), (uint8_t)payload.size()}};
+
+    serializer.set_object(segments.data(), segments.size());
+    EXPECT_EQ(1U + 11U, serializer.max_write_buffer_size());
+
+    std::vector<std::vector<uint8_t>> buffers;
+    while (!serializer.object_proccessed())
+    {
+        std::vector<uint8_t> buffer(std::min<uint8_t>(
+            4, serializer.max_write_buffer_size()));
+        serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+        buffers.push_back(buffer);
+    }
+
+    std::vector<std::vector<uint8_t>> expected_buffers = {
+        {0b10000000 | 11, 0, 1, 2},
+        {8, 3, 4, 5},
+        {5, 6, 7, 8},
+        {2, 9, 10}};
+
+    EXPECT_EQ(expected_buffers, buffers);
+
+    // A contiguous object can follow
+    serializer.set_object(payload.data(), (uint8_t)payload.size());
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+    EXPECT_EQ(std::vector<uint8_t>({0b10000000 | 6, 5, 6, 7, 8, 9, 10}),
+              buffer);
+
+    // Leading empty segments are skipped
+    segments = {{nullptr, 0},
+                {payload.data(), 0},
+                {header.data(), (uint8_t)header.size()}};
+
+    serializer.set_object(segments.data(), segments.size());
+    EXPECT_FALSE(serializer.object_proccessed());
+
+    buffer.resize(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint8_t)buffer.size());
+    EXPECT_TRUE(serializer.object_proccessed());
+    EXPECT_EQ(std::vector<uint8_t>({0b10000000 | 2, 0, 1}), buffer);
+}
+
+// The object is spread evenly over the smallest number of buffers
+TEST(test_serializer, balanced_buffers)
+{
+    using serializer_type = chunkie::serializer<uint16_t>;
+    serializer_type serializer;
+
+    std::vector<uint8_t> object(1001);
+    serializer.set_object(object.data(), (uint16_t)object.size());
+
+    // 1000 byte buffers fit 998 bytes of data each
+    EXPECT_EQ(2U, serializer.buffer_count(1000));
+
+    std::vector<uint16_t> sizes;
+    while (!serializer.object_proccessed())
+    {
+        auto size = serializer.balanced_buffer_size(1000);
+        std::vector<uint8_t> buffer(size);
+        serializer.write_buffer(buffer.data(), size);
+        sizes.push_back(size);
+    }
+    EXPECT_EQ(std::vector<uint16_t>({503, 502}), sizes);
+
+    for (uint16_t object_size : {1, 2, 997, 998, 999, 2000, 9999})
+    {
+        object.resize(object_size);
+        serializer.set_object(object.data(), object_size);
+
+        auto count = serializer.buffer_count(100);
+        std::size_t total = object_size + count * 2U;
+        sizes.clear();
+
+        while (!serializer.object_proccessed())
+        {
+            auto size = serializer.balanced_buffer_size(100);
+            std::vector<uint8_t> buffer(size);
+            serializer.write_buffer(buffer.data(), size);
+            sizes.push_back(size);
+        }
+
+        EXPECT_EQ(count, sizes.size());
+        auto minmax = std::minmax_element(sizes.begin(), sizes.end());
+        EXPECT_GE(100U, *minmax.second);
+        EXPECT_GE(1U, (uint32_t)(*minmax.second - *minmax.first));
+        EXPECT_EQ(total, std::accumulate(sizes.begin(), sizes.end(), 0U));
+    }
+}
+
+// The first buffer holds the extension even when spreading the object
+TEST(test_serializer, balanced_buffers_extension)
+{
+    using serializer_type = chunkie::serializer<uint8_t, tag_extension>;
+    serializer_type serializer;
+
+    std::vector<uint8_t> object = {1, 2};
+    serializer.set_object(object.data(), (uint8_t)object.size());
+
+    // Two buffers of up to 4 bytes are needed
+    EXPECT_EQ(2U, serializer.buffer_count(4));
+
+    std::vector<uint8_t> sizes;
+    while (!serializer.object_proccessed())
+    {
+        auto size = serializer.balanced_buffer_size(4);
+        std::vector<uint8_t> buffer(size);
+        serializer.write_buffer(buffer.data(), size);
+        sizes.push_back(size);
+    }
+    EXPECT_EQ(std::vector<uint8_t>({4, 2}), sizes);
+}
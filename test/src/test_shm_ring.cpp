@@ -0,0 +1,230 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__linux__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/shm_ring.hpp>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+std::string ring_name()
+{
+    return "/chunkie_test_" + std::to_string(::getpid());
+}
+}
+
+TEST(test_shm_ring, open_errors)
+{
+    std::error_code error;
+    chunkie::shm_ring ring;
+
+    ring.open(ring_name(), error);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, error);
+    EXPECT_FALSE(ring.is_open());
+
+    chunkie::shm_ring writer;
+    error = std::error_code();
+    writer.create(ring_name(), 100, 4, error);
+    ASSERT_FALSE(error);
+
+    // The name is taken
+    chunkie::shm_ring other;
+    other.create(ring_name(), 100, 4, error);
+    EXPECT_EQ(std::errc::file_exists, error);
+
+    error = std::error_code();
+    chunkie::shm_ring::remove(ring_name(), error);
+    EXPECT_FALSE(error);
+}
+
+// A segment with a slot count that is not a power of two is rejected
+TEST(test_shm_ring, invalid_slot_count)
+{
+    std::error_code error;
+    chunkie::shm_ring writer;
+    writer.create(ring_name(), 188, 4, error);
+    ASSERT_FALSE(error);
+
+    // Rewrite the control block to 3 slots of 252 bytes, which take up the
+    // same space as 4 slots of 188 bytes
+    int fd = ::shm_open(ring_name().c_str(), O_RDWR, 0);
+    ASSERT_LE(0, fd);
+    uint64_t fields[2] = {252, 3};
+    ASSERT_EQ((ssize_t)sizeof(fields), ::pwrite(fd, fields, sizeof(fields), 8));
+    ::close(fd);
+
+    chunkie::shm_ring reader;
+    reader.open(ring_name(), error);
+    EXPECT_EQ(chunkie::error::invalid_ring, error);
+    EXPECT_FALSE(reader.is_open());
+
+    error = std::error_code();
+    chunkie::shm_ring::remove(ring_name(), error);
+    EXPECT_FALSE(error);
+}
+
+// A slot length larger than the slot size is reported instead of read
+TEST(test_shm_ring, invalid_slot_length)
+{
+    std::error_code error;
+    chunkie::shm_ring writer;
+    writer.create(ring_name(), 10, 2, error);
+    ASSERT_FALSE(error);
+
+    chunkie::shm_ring reader;
+    reader.open(ring_name(), error);
+    ASSERT_FALSE(error);
+    chunkie::shm_ring::remove(ring_name(), error);
+
+    uint8_t* slot = writer.prepare();
+    ASSERT_NE(nullptr, slot);
+    writer.commit(1);
+
+    // Corrupt the length prefix of the published slot
+    uint32_t length = 1000;
+    std::memcpy(slot - chunkie::shm_ring::slot_header_size, &length,
+                sizeof(length));
+
+    EXPECT_TRUE(reader.wait_readable());
+
+    std::size_t size = 0;
+    EXPECT_EQ(nullptr, reader.peek(size, error));
+    EXPECT_EQ(chunkie::error::invalid_ring, error);
+}
+
+TEST(test_shm_ring, full_and_empty)
+{
+    std::error_code error;
+    chunkie::shm_ring writer;
+    writer.create(ring_name(), 10, 2, error);
+    ASSERT_FALSE(error);
+
+    chunkie::shm_ring reader;
+    reader.open(ring_name(), error);
+    ASSERT_FALSE(error);
+    chunkie::shm_ring::remove(ring_name(), error);
+
+    EXPECT_EQ(10U, reader.slot_size());
+    EXPECT_EQ(2U, reader.slot_count());
+
+    std::size_t size = 0;
+    EXPECT_EQ(nullptr, reader.peek(size, error));
+
+    for (uint8_t i = 1; i <= 2; ++i)
+    {
+        uint8_t* slot = writer.prepare();
+        ASSERT_NE(nullptr, slot);
+        slot[0] = i;
+        writer.commit(i);
+    }
+    EXPECT_EQ(nullptr, writer.prepare());
+
+    const uint8_t* buffer = reader.peek(size, error);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(1U, size);
+    EXPECT_EQ(1U, buffer[0]);
+    reader.release();
+
+    EXPECT_NE(nullptr, writer.prepare());
+
+    buffer = reader.peek(size, error);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(2U, size);
+    EXPECT_EQ(2U, buffer[0]);
+    reader.release();
+    EXPECT_EQ(nullptr, reader.peek(size, error));
+
+    // Nothing was waiting, so no wake ups were needed
+    EXPECT_EQ(0U, writer.wake_ups());
+    EXPECT_EQ(0U, reader.wake_ups());
+
+    writer.shutdown();
+    EXPECT_FALSE(reader.wait_readable());
+}
+
+// Objects are serialized into the ring and deserialized in place by another
+// thread, both sides sleeping when the ring is full or empty
+TEST(test_shm_ring, stream)
+{
+    std::error_code error;
+    chunkie::shm_ring writer;
+    writer.create(ring_name(), 100, 4, error);
+    ASSERT_FALSE(error);
+
+    chunkie::shm_ring reader;
+    reader.open(ring_name(), error);
+    ASSERT_FALSE(error);
+    chunkie::shm_ring::remove(ring_name(), error);
+
+    const uint32_t object_count = 2000;
+
+    std::thread producer(
+        [&writer]()
+        {
+            chunkie::serializer<uint32_t> serializer;
+            std::vector<uint8_t> object;
+
+            for (uint32_t i = 0; i < object_count; ++i)
+            {
+                object.assign(1 + (i % 250), (uint8_t)i);
+                serializer.set_object(object.data(),
+                                      (uint32_t)object.size());
+
+                while (!serializer.object_proccessed())
+                {
+                    writer.wait_writable();
+                    auto size = std::min<uint32_t>(
+                        100, serializer.max_write_buffer_size());
+                    serializer.write_buffer(writer.prepare(), size);
+                    writer.commit(size);
+                }
+            }
+            writer.shutdown();
+        });
+
+    chunkie::deserializer<uint32_t> deserializer;
+    std::vector<uint8_t> object;
+    uint32_t received = 0;
+
+    while (reader.wait_readable())
+    {
+        std::size_t size = 0;
+        const uint8_t* buffer = reader.peek(size, error);
+        ASSERT_FALSE(error);
+
+        deserializer.set_buffer(buffer, (uint32_t)size);
+        while (!deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                EXPECT_EQ(std::vector<uint8_t>(1 + (received % 250),
+                                               (uint8_t)received),
+                          object);
+                received++;
+            }
+        }
+        reader.release();
+    }
+
+    producer.join();
+    EXPECT_EQ(object_count, received);
+}
+
+#endif
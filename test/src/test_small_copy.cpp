@@ -0,0 +1,31 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/small_copy.hpp>
+
+#include <vector>
+
+// Copy every size up to a few blocks without touching surrounding bytes
+TEST(test_small_copy, sizes)
+{
+    for (std::size_t size = 0; size <= 100; ++size)
+    {
+        std::vector<uint8_t> source(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            source[i] = (uint8_t)(i + 1);
+        }
+
+        std::vector<uint8_t> destination(size + 2, 0xff);
+        chunkie::small_copy(destination.data() + 1, source.data(), size);
+
+        EXPECT_EQ(0xff, destination.front());
+        EXPECT_EQ(0xff, destination.back());
+        EXPECT_EQ(source, std::vector<uint8_t>(destination.begin() + 1,
+                                               destination.end() - 1));
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/spsc_queue.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST(test_spsc_queue, basic)
+{
+    chunkie::spsc_queue<uint32_t> queue(4);
+    EXPECT_EQ(4U, queue.capacity());
+    EXPECT_TRUE(queue.empty());
+
+    uint32_t value = 0;
+    EXPECT_FALSE(queue.try_pop(value));
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        value = i;
+        EXPECT_TRUE(queue.try_push(value));
+    }
+
+    value = 4;
+    EXPECT_FALSE(queue.try_push(value));
+    EXPECT_FALSE(queue.empty());
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(i, value);
+    }
+
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(test_spsc_queue, threads)
+{
+    chunkie::spsc_queue<std::vector<uint8_t>> queue(16);
+
+    const uint32_t values = 10000;
+
+    std::thread producer(
+        [&queue]()
+        {
+            for (uint32_t i = 0; i < values; ++i)
+            {
+                std::vector<uint8_t> value(1 + (i % 100), (uint8_t)i);
+                while (!queue.try_push(value))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    std::vector<uint8_t> value;
+    for (uint32_t i = 0; i < values; ++i)
+    {
+        while (!queue.try_pop(value))
+        {
+            std::this_thread::yield();
+        }
+
+        ASSERT_EQ(1 + (i % 100), value.size());
+        EXPECT_EQ((uint8_t)i, value.front());
+    }
+
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
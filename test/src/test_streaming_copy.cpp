@@ -0,0 +1,73 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/streaming_copy.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// Copy sizes and alignments around the streaming threshold
+TEST(test_streaming_copy, copy)
+{
+    std::vector<uint8_t> source(5000);
+    for (std::size_t i = 0; i < source.size(); ++i)
+    {
+        source[i] = (uint8_t)(i * 7);
+    }
+
+    std::vector<std::size_t> sizes = {0, 1, 255, 256, 257, 1000, 4096, 4900};
+
+    for (auto size : sizes)
+    {
+        for (std::size_t misalignment = 0; misalignment < 17; ++misalignment)
+        {
+            std::vector<uint8_t> destination(size + 40, 0);
+            chunkie::streaming_copy::copy(destination.data() + misalignment,
+                                          source.data() + 3, size, size);
+
+            EXPECT_TRUE(std::equal(source.begin() + 3,
+                                   source.begin() + 3 + size,
+                                   destination.begin() + misalignment));
+            EXPECT_EQ(0U, destination[misalignment + size]);
+        }
+    }
+}
+
+TEST(test_streaming_copy, serialize_deserialize)
+{
+    chunkie::serializer<uint32_t, chunkie::no_extension,
+                        chunkie::streaming_copy>
+        serializer;
+    chunkie::deserializer<uint32_t, chunkie::no_extension,
+                          chunkie::streaming_copy>
+        deserializer;
+
+    std::vector<uint8_t> object(100000);
+    for (std::size_t i = 0; i < object.size(); ++i)
+    {
+        object[i] = (uint8_t)rand();
+    }
+
+    std::vector<uint8_t> result(object.size());
+    std::vector<uint8_t> buffer;
+    serializer.set_object(object.data(), (uint32_t)object.size());
+
+    while (!serializer.object_proccessed())
+    {
+        buffer.resize(
+            std::min<uint32_t>(9000, serializer.max_write_buffer_size()));
+        serializer.write_buffer(buffer.data(), (uint32_t)buffer.size());
+
+        deserializer.set_buffer(buffer.data(), (uint32_t)buffer.size());
+        deserializer.write_to_object(result.data());
+    }
+
+    EXPECT_TRUE(deserializer.object_completed());
+    EXPECT_EQ(object, result);
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/submission_serializer.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST(test_submission_serializer, packing)
+{
+    chunkie::submission_serializer<uint8_t> serializer;
+    EXPECT_FALSE(serializer.has_objects());
+
+    std::vector<uint8_t> first_object = {1, 2, 3};
+    std::vector<uint8_t> second_object = {4, 5, 6, 7};
+
+    chunkie::submission first;
+    first.m_data = first_object.data();
+    first.m_size = first_object.size();
+    chunkie::submission second;
+    second.m_data = second_object.data();
+    second.m_size = second_object.size();
+
+    serializer.submit(first);
+    serializer.submit(second);
+    EXPECT_FALSE(first.completed());
+    EXPECT_TRUE(serializer.has_objects());
+
+    std::vector<uint8_t> buffer(7, 0);
+    EXPECT_EQ(7U, serializer.write_buffer(buffer.data(), 7));
+    EXPECT_EQ(std::vector<uint8_t>({0b10000000 | 3, 1, 2, 3, 0b10000000 | 4,
+                                    4, 5}),
+              buffer);
+    EXPECT_TRUE(first.completed());
+    EXPECT_FALSE(second.completed());
+
+    buffer.assign(7, 0);
+    EXPECT_EQ(3U, serializer.write_buffer(buffer.data(), 7));
+    EXPECT_EQ(std::vector<uint8_t>({2, 6, 7, 0, 0, 0, 0}), buffer);
+    EXPECT_TRUE(second.completed());
+    EXPECT_EQ(2U, serializer.completed_objects());
+
+    EXPECT_FALSE(serializer.has_objects());
+    EXPECT_EQ(0U, serializer.write_buffer(buffer.data(), 7));
+}
+
+// Producers reuse their object once it is completed
+TEST(test_submission_serializer, threads)
+{
+    chunkie::submission_serializer<uint32_t> serializer;
+
+    const uint32_t producers = 4;
+    const uint32_t objects = 2000;
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(
+            [&serializer, p]()
+            {
+                std::vector<uint8_t> object;
+                chunkie::submission submission;
+
+                for (uint32_t i = 0; i < objects; ++i)
+                {
+                    // The object starts with the producer and a counter
+                    object.assign(2 + (i % 300), (uint8_t)i);
+                    object[0] = (uint8_t)p;
+
+                    submission.m_data = object.data();
+                    submission.m_size = object.size();
+                    serializer.submit(submission);
+
+                    while (!submission.completed())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    chunkie::deserializer<uint32_t> deserializer;
+    std::vector<uint8_t> buffer(1400);
+    std::vector<uint8_t> object;
+    std::vector<uint32_t> received(producers, 0);
+    uint32_t total = 0;
+
+    while (total < producers * objects)
+    {
+        auto size = serializer.write_buffer(buffer.data(), 1400);
+        if (size <= 4)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        deserializer.set_buffer(buffer.data(), size);
+        while (!deserializer.buffer_proccessed())
+        {
+            object.resize(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            if (deserializer.object_completed())
+            {
+                auto p = object[0];
+                auto i = received[p];
+                ASSERT_EQ(2 + (i % 300), object.size());
+                EXPECT_EQ((uint8_t)i, object.back());
+                received[p]++;
+                total++;
+            }
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(producers * objects, serializer.completed_objects());
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/threshold_copy.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Copy policy recording which policy was used
+template <uint8_t Marker>
+struct marker_copy
+{
+    static void copy(uint8_t* destination, const uint8_t* source,
+                     std::size_t size, std::size_t object_size)
+    {
+        (void)source;
+        (void)object_size;
+        std::fill(destination, destination + size, Marker);
+    }
+};
+}
+
+// The policy is chosen by the size of the object, not of the copy
+TEST(test_threshold_copy, copy)
+{
+    using copy_type =
+        chunkie::threshold_copy<1000, marker_copy<1>, marker_copy<2>>;
+
+    std::vector<uint8_t> source(10);
+    std::vector<uint8_t> destination(10);
+
+    copy_type::copy(destination.data(), source.data(), 10, 999);
+    EXPECT_EQ(std::vector<uint8_t>(10, 1), destination);
+
+    copy_type::copy(destination.data(), source.data(), 10, 1000);
+    EXPECT_EQ(std::vector<uint8_t>(10, 2), destination);
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/timestamp_extension.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(test_timestamp_extension, write_read)
+{
+    using extension_type = chunkie::timestamp_extension<>;
+    EXPECT_EQ(8U, extension_type::size);
+
+    extension_type extension;
+    extension.on_set_object();
+    EXPECT_LT(0U, extension.timestamp());
+
+    std::vector<uint8_t> data(extension_type::size);
+    extension.write(data.data());
+
+    extension_type read;
+    read.read(data.data());
+    EXPECT_EQ(extension.timestamp(), read.timestamp());
+    EXPECT_EQ(1U, read.time_to_first_fragment().count());
+    EXPECT_EQ(0U, read.time_to_completion().count());
+
+    read.on_object_completed();
+    EXPECT_EQ(1U, read.time_to_completion().count());
+}
+
+// The deserializer records the latency of every object
+TEST(test_timestamp_extension, serialize_deserialize)
+{
+    using extension_type = chunkie::timestamp_extension<>;
+    chunkie::serializer<uint32_t, extension_type> serializer;
+    chunkie::deserializer<uint32_t, extension_type> deserializer;
+
+    std::vector<uint8_t> object(100, 'x');
+    std::vector<uint8_t> result(object.size());
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+
+        std::vector<std::vector<uint8_t>> buffers;
+        while (!serializer.object_proccessed())
+        {
+            std::vector<uint8_t> buffer(
+                std::min<uint32_t>(40, serializer.max_write_buffer_size()));
+            serializer.write_buffer(buffer.data(), (uint32_t)buffer.size());
+            buffers.push_back(buffer);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        for (const auto& buffer : buffers)
+        {
+            deserializer.set_buffer(buffer.data(), (uint32_t)buffer.size());
+            while (!deserializer.buffer_proccessed())
+            {
+                deserializer.write_to_object(result.data());
+            }
+        }
+
+        EXPECT_TRUE(deserializer.object_completed());
+        EXPECT_EQ(object, result);
+    }
+
+    const auto& extension = deserializer.extension();
+    EXPECT_EQ(10U, extension.time_to_first_fragment().count());
+    EXPECT_EQ(10U, extension.time_to_completion().count());
+    EXPECT_LE(1000000U, extension.time_to_first_fragment().percentile(0));
+    EXPECT_LE(extension.time_to_first_fragment().max(),
+              extension.time_to_completion().max());
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/tiny_deserializer.hpp>
+
+#include <vector>
+
+TEST(test_tiny_deserializer, read_objects)
+{
+    chunkie::tiny_deserializer<uint8_t> deserializer;
+
+    // Two objects followed by zero padding
+    std::vector<uint8_t> buffer = {0b10000000 | 4, 0, 1, 2, 3, 0b10000000 | 2,
+                                   4,              5, 0, 0};
+
+    std::vector<chunkie::object_view<uint8_t>> views(10);
+    std::size_t consumed = 0;
+    auto count = deserializer.read_objects(buffer.data(), buffer.size(),
+                                           views.data(), views.size(),
+                                           consumed);
+
+    ASSERT_EQ(2U, count);
+    EXPECT_EQ(8U, consumed);
+    EXPECT_EQ(buffer.data() + 1, views[0].m_data);
+    EXPECT_EQ(4U, views[0].m_size);
+    EXPECT_EQ(buffer.data() + 6, views[1].m_data);
+    EXPECT_EQ(2U, views[1].m_size);
+
+    // The number of views limits the objects read
+    count = deserializer.read_objects(buffer.data(), buffer.size(),
+                                      views.data(), 1, consumed);
+    EXPECT_EQ(1U, count);
+    EXPECT_EQ(5U, consumed);
+}
+
+// The sweep stops at objects which are not complete in the buffer
+TEST(test_tiny_deserializer, partial_objects)
+{
+    chunkie::tiny_deserializer<uint8_t> deserializer;
+
+    std::vector<uint8_t> buffer = {0b10000000 | 1, 7, 0b10000000 | 4, 0, 1};
+
+    std::vector<chunkie::object_view<uint8_t>> views(10);
+    std::size_t consumed = 0;
+    auto count = deserializer.read_objects(buffer.data(), buffer.size(),
+                                           views.data(), views.size(),
+                                           consumed);
+    EXPECT_EQ(1U, count);
+    EXPECT_EQ(2U, consumed);
+
+    // A continued object is left for the deserializer
+    std::vector<uint8_t> continued = {3, 1, 2, 3, 0b10000000 | 1, 7};
+    count = deserializer.read_objects(continued.data(), continued.size(),
+                                      views.data(), views.size(), consumed);
+    EXPECT_EQ(0U, count);
+    EXPECT_EQ(0U, consumed);
+}
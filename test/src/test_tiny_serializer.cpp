@@ -0,0 +1,89 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/tiny_serializer.hpp>
+
+#include <vector>
+
+TEST(test_tiny_serializer, write_objects)
+{
+    using serializer_type = chunkie::tiny_serializer<uint8_t>;
+    serializer_type serializer;
+
+    EXPECT_EQ(1U, serializer_type::header_size);
+    EXPECT_EQ(127U, serializer_type::max_object_size);
+
+    std::vector<std::vector<uint8_t>> objects = {
+        {0, 1, 2, 3}, {4, 5, 6, 7, 8, 9}, {10, 11, 12}};
+
+    std::vector<chunkie::object_view<uint8_t>> views;
+    for (const auto& object : objects)
+    {
+        views.push_back({object.data(), (uint8_t)object.size()});
+    }
+
+    // Only the objects which fit completely are written
+    std::vector<uint8_t> buffer(14);
+    std::size_t written = 0;
+    auto count = serializer.write_objects(views.data(), views.size(),
+                                          buffer.data(), buffer.size(),
+                                          written);
+
+    EXPECT_EQ(2U, count);
+    EXPECT_EQ(12U, written);
+
+    std::vector<uint8_t> expected = {0b10000000 | 4, 0, 1, 2, 3,
+                                     0b10000000 | 6, 4, 5, 6, 7,
+                                     8,              9, 0, 0};
+    EXPECT_EQ(expected, buffer);
+}
+
+// The buffers can be read by the deserializer
+TEST(test_tiny_serializer, deserialize)
+{
+    chunkie::tiny_serializer<uint16_t> serializer;
+    chunkie::deserializer<uint16_t> deserializer;
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<chunkie::object_view<uint16_t>> views;
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 64), (uint8_t)i);
+    }
+    for (const auto& object : objects)
+    {
+        views.push_back({object.data(), (uint16_t)object.size()});
+    }
+
+    std::vector<std::vector<uint8_t>> results;
+    std::vector<uint8_t> buffer(500);
+    std::size_t index = 0;
+
+    while (index < views.size())
+    {
+        std::size_t written = 0;
+        auto count = serializer.write_objects(views.data() + index,
+                                              views.size() - index,
+                                              buffer.data(), buffer.size(),
+                                              written);
+        ASSERT_LT(0U, count);
+        index += count;
+
+        deserializer.set_buffer(buffer.data(), (uint16_t)written);
+        while (!deserializer.buffer_proccessed())
+        {
+            std::vector<uint8_t> object(deserializer.object_size());
+            deserializer.write_to_object(object.data());
+            EXPECT_TRUE(deserializer.object_completed());
+            results.push_back(object);
+        }
+    }
+
+    EXPECT_EQ(objects, results);
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/transform_deserializer.hpp>
+#include <chunkie/transform_serializer.hpp>
+
+#include <algorithm>
+#include <vector>
+
+TEST(test_transform_deserializer, basic)
+{
+    chunkie::transform_deserializer<chunkie::rle_codec, uint16_t> deserializer;
+
+    // A transformed object of 100 zeros followed by an untransformed object
+    std::vector<uint8_t> buffer = {0x80, 2, 0x80, 100, 128 + 97, 0,
+                                   0x80, 3, 0,    3,   1,        2, 3};
+
+    deserializer.set_buffer(buffer.data(), (uint16_t)buffer.size());
+
+    EXPECT_EQ(100U, deserializer.object_size());
+    std::vector<uint8_t> first(deserializer.object_size());
+    deserializer.write_to_object(first.data());
+    EXPECT_TRUE(deserializer.object_completed());
+    EXPECT_EQ(std::vector<uint8_t>(100, 0), first);
+
+    EXPECT_EQ(3U, deserializer.object_size());
+    std::vector<uint8_t> second(deserializer.object_size());
+    deserializer.write_to_object(second.data());
+    EXPECT_TRUE(deserializer.object_completed());
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3}), second);
+
+    EXPECT_TRUE(deserializer.buffer_proccessed());
+}
+
+// An object which fails to decode is not completed
+TEST(test_transform_deserializer, invalid)
+{
+    chunkie::transform_deserializer<chunkie::rle_codec, uint16_t> deserializer;
+
+    std::vector<uint8_t> buffer = {0x80, 2, 0x80, 100, 128 + 2, 0};
+
+    deserializer.set_buffer(buffer.data(), (uint16_t)buffer.size());
+
+    std::vector<uint8_t> object(deserializer.object_size());
+    deserializer.write_to_object(object.data());
+    EXPECT_FALSE(deserializer.object_completed());
+    EXPECT_TRUE(deserializer.buffer_proccessed());
+}
+
+// Serialize and deserialize objects spanning many buffers
+TEST(test_transform_deserializer, serialize_deserialize)
+{
+    chunkie::transform_serializer<> serializer;
+    chunkie::transform_deserializer<> deserializer;
+
+    std::vector<std::vector<uint8_t>> objects;
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        std::vector<uint8_t> object(1 + (rand() % 5000));
+        for (auto& byte : object)
+        {
+            // Alternate between compressible and random objects
+            byte = i % 2 ? (uint8_t)(rand() % 2) : (uint8_t)rand();
+        }
+        objects.push_back(object);
+    }
+
+    std::vector<std::vector<uint8_t>> results;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> result;
+    uint32_t buffers = 0;
+
+    for (const auto& object : objects)
+    {
+        serializer.set_object(object.data(), (uint32_t)object.size());
+
+        while (!serializer.object_proccessed())
+        {
+            buffer.resize(
+                std::min<uint32_t>(200, serializer.max_write_buffer_size()));
+            serializer.write_buffer(buffer.data(), (uint32_t)buffer.size());
+            buffers++;
+
+            deserializer.set_buffer(buffer.data(), (uint32_t)buffer.size());
+            while (!deserializer.buffer_proccessed())
+            {
+                result.resize(deserializer.object_size());
+                deserializer.write_to_object(result.data());
+                if (deserializer.object_completed())
+                {
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(objects, results);
+    EXPECT_LT(0U, buffers);
+}
@@ -0,0 +1,36 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/transform_extension.hpp>
+
+#include <vector>
+
+TEST(test_transform_extension, write_read)
+{
+    using extension_type = chunkie::transform_extension<uint16_t>;
+    EXPECT_EQ(2U, extension_type::size);
+
+    std::vector<uint8_t> data(extension_type::size);
+
+    extension_type extension;
+    extension.set(true, 0x1234);
+    extension.write(data.data());
+    EXPECT_EQ(std::vector<uint8_t>({0x80 | 0x12, 0x34}), data);
+
+    extension_type read;
+    read.read(data.data());
+    EXPECT_TRUE(read.transformed());
+    EXPECT_EQ(0x1234U, read.original_size());
+
+    extension.set(false, 7);
+    extension.write(data.data());
+    EXPECT_EQ(std::vector<uint8_t>({0, 7}), data);
+
+    read.read(data.data());
+    EXPECT_FALSE(read.transformed());
+    EXPECT_EQ(7U, read.original_size());
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <gtest/gtest.h>
+
+#include <chunkie/transform_serializer.hpp>
+
+#include <vector>
+
+// Compressible objects are sent transformed
+TEST(test_transform_serializer, transformed)
+{
+    chunkie::transform_serializer<chunkie::rle_codec, uint16_t> serializer;
+
+    std::vector<uint8_t> object(100, 0);
+    serializer.set_object(object.data(), (uint16_t)object.size());
+
+    EXPECT_TRUE(serializer.object_transformed());
+    EXPECT_EQ(2U, serializer.transformed_size());
+    EXPECT_EQ(2U + 2U + 2U, serializer.max_write_buffer_size());
+
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint16_t)buffer.size());
+
+    std::vector<uint8_t> expected = {0x80, 2, 0x80, 100, 128 + 97, 0};
+    EXPECT_EQ(expected, buffer);
+    EXPECT_TRUE(serializer.object_proccessed());
+}
+
+// Objects which do not shrink are sent as is
+TEST(test_transform_serializer, not_transformed)
+{
+    chunkie::transform_serializer<chunkie::rle_codec, uint16_t> serializer;
+
+    std::vector<uint8_t> object = {1, 2, 3};
+    serializer.set_object(object.data(), (uint16_t)object.size());
+
+    EXPECT_FALSE(serializer.object_transformed());
+    EXPECT_EQ(3U, serializer.transformed_size());
+
+    std::vector<uint8_t> buffer(serializer.max_write_buffer_size());
+    serializer.write_buffer(buffer.data(), (uint16_t)buffer.size());
+
+    std::vector<uint8_t> expected = {0x80, 3, 0, 3, 1, 2, 3};
+    EXPECT_EQ(expected, buffer);
+    EXPECT_TRUE(serializer.object_proccessed());
+}
@@ -0,0 +1,181 @@
+// Copyright (c) 2018 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#if defined(__linux__)
+
+#include <gtest/gtest.h>
+
+#include <chunkie/deserializer.hpp>
+#include <chunkie/serializer.hpp>
+#include <chunkie/udp_receiver.hpp>
+#include <chunkie/udp_sender.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+namespace
+{
+// A pair of UDP sockets connected over the loopback interface
+struct loopback
+{
+    loopback()
+    {
+        receiver = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+        int size = 4 * 1024 * 1024;
+        ::setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        ::bind(receiver, (sockaddr*)&address, sizeof(address));
+
+        socklen_t length = sizeof(address);
+        ::getsockname(receiver, (sockaddr*)&address, &length);
+        ::connect(sender, (sockaddr*)&address, sizeof(address));
+    }
+
+    ~loopback()
+    {
+        ::close(receiver);
+        ::close(sender);
+    }
+
+    int receiver;
+    int sender;
+};
+
+void send_and_receive(bool gso, bool gro)
+{
+    loopback sockets;
+    ASSERT_LE(0, sockets.receiver);
+    ASSERT_LE(0, sockets.sender);
+
+    const uint32_t max_buffer_size = 1400;
+    const uint32_t batch_size = 32;
+
+    chunkie::udp_sender sender(sockets.sender, max_buffer_size, batch_size);
+    sender.set_gso(gso);
+    chunkie::udp_receiver receiver(sockets.receiver, max_buffer_size,
+                                   batch_size, gro);
+
+    chunkie::serializer<uint32_t> serializer;
+    chunkie::deserializer<uint32_t> deserializer;
+
+    std::vector<std::vector<uint8_t>> objects;
+    std::vector<std::vector<uint8_t>> restored;
+    std::vector<uint8_t> object;
+
+    auto receive = [&]()
+    {
+        std::error_code error;
+        while (receiver.received_buffers() < sender.sent_buffers())
+        {
+            receiver.receive(error);
+            ASSERT_FALSE(error);
+
+            for (std::size_t i = 0; i < receiver.buffers(); ++i)
+            {
+                deserializer.set_buffer(receiver.buffer_data(i),
+                                        (uint32_t)receiver.buffer_size(i));
+
+                while (!deserializer.buffer_proccessed())
+                {
+                    object.resize(deserializer.object_size());
+                    deserializer.write_to_object(object.data());
+                    if (deserializer.object_completed())
+                    {
+                        restored.push_back(object);
+                    }
+                }
+            }
+        }
+    };
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        objects.emplace_back(1 + (rand() % 20000), (uint8_t)rand());
+        const auto& next = objects.back();
+
+        serializer.set_object(next.data(), (uint32_t)next.size());
+        while (!serializer.object_proccessed())
+        {
+            std::error_code error;
+            uint8_t* buffer = sender.prepare(error);
+            ASSERT_FALSE(error);
+
+            auto size = std::min<uint32_t>(max_buffer_size,
+                                           serializer.max_write_buffer_size());
+            serializer.write_buffer(buffer, size);
+            sender.commit(size);
+
+            if (sender.queued_buffers() == batch_size)
+            {
+                sender.flush(error);
+                ASSERT_FALSE(error);
+                receive();
+            }
+        }
+    }
+
+    std::error_code error;
+    sender.flush(error);
+    ASSERT_FALSE(error);
+    receive();
+
+    EXPECT_EQ(objects, restored);
+    EXPECT_EQ(sender.sent_buffers(), receiver.received_buffers());
+
+    // Batching needs far fewer system calls than buffers
+    EXPECT_LT(sender.system_calls() * 4, sender.sent_buffers());
+}
+}
+
+TEST(test_udp, batched)
+{
+    send_and_receive(false, false);
+}
+
+TEST(test_udp, segmentation_offload)
+{
+    send_and_receive(true, true);
+}
+
+// Datagrams larger than a buffer are dropped instead of passed on truncated
+TEST(test_udp, truncated_datagram)
+{
+    loopback sockets;
+    ASSERT_LE(0, sockets.receiver);
+    ASSERT_LE(0, sockets.sender);
+
+    chunkie::udp_receiver receiver(sockets.receiver, 100, 4);
+
+    std::vector<uint8_t> oversized(200, 1);
+    std::vector<uint8_t> datagram(100, 2);
+    ASSERT_EQ(200, ::send(sockets.sender, oversized.data(), 200, 0));
+    ASSERT_EQ(100, ::send(sockets.sender, datagram.data(), 100, 0));
+
+    std::error_code error;
+    while (receiver.received_buffers() == 0)
+    {
+        receiver.receive(error);
+        ASSERT_FALSE(error);
+    }
+
+    EXPECT_EQ(1U, receiver.truncated_buffers());
+    ASSERT_EQ(1U, receiver.buffers());
+    EXPECT_EQ(100U, receiver.buffer_size(0));
+    EXPECT_EQ(datagram, std::vector<uint8_t>(receiver.buffer_data(0),
+                                             receiver.buffer_data(0) + 100));
+}
+
+#endif